@@ -0,0 +1,39 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common.js');
+
+var bench = common.createBenchmark(main, {
+  encoding: ['base64', 'hex'],
+  size: [64, 1024, 32 * 1024 * 1024]
+});
+
+// Reports GB/s of output.
+function main(conf) {
+  var size = conf.size | 0;
+  var n = Math.max(1, (1024 * 1024 * 1024 / size) | 0);
+  var b = Buffer(size);
+  for (var i = 0; i < size; ++i) b[i] = i & 255;
+  var s = b.toString(conf.encoding);
+  bench.start();
+  for (var i = 0; i < n; ++i) b.write(s, 0, conf.encoding);
+  bench.end(n * size / 1e9);
+}
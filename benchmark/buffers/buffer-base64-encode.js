@@ -21,15 +21,20 @@
 
 var common = require('../common.js');
 
-var bench = common.createBenchmark(main, {});
+var bench = common.createBenchmark(main, {
+  encoding: ['base64', 'hex'],
+  size: [64, 1024, 64 * 1024 * 1024]
+});
 
+// Reports GB/s of input.
 function main(conf) {
-  var N = 64 * 1024 * 1024;
-  var b = Buffer(N);
+  var size = conf.size | 0;
+  var n = Math.max(1, (2048 * 1024 * 1024 / size) | 0);
+  var b = Buffer(size);
   var s = '';
   for (var i = 0; i < 256; ++i) s += String.fromCharCode(i);
-  for (var i = 0; i < N; i += 256) b.write(s, i, 256, 'ascii');
+  for (var i = 0; i < size; i += 256) b.write(s, i, 256, 'binary');
   bench.start();
-  for (var i = 0; i < 32; ++i) b.toString('base64');
-  bench.end(64);
+  for (var i = 0; i < n; ++i) b.toString(conf.encoding);
+  bench.end(n * size / 1e9);
 }
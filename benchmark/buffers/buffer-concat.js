@@ -0,0 +1,26 @@
+var common = require('../common.js');
+
+var bench = common.createBenchmark(main, {
+  pieces: [1, 4, 16, 256],
+  pieceSize: [1, 16, 256],
+  withTotalLength: [0, 1],
+  n: [1024]
+});
+
+function main(conf) {
+  var n = +conf.n;
+  var size = +conf.pieceSize;
+  var pieces = +conf.pieces;
+
+  var list = [];
+  for (var i = 0; i < pieces; i++)
+    list.push(new Buffer(size));
+
+  var totalLength = conf.withTotalLength ? pieces * size : undefined;
+
+  bench.start();
+  for (var i = 0; i < n * 1024; i++) {
+    Buffer.concat(list, totalLength);
+  }
+  bench.end(n);
+}
@@ -0,0 +1,47 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common.js');
+
+var bench = common.createBenchmark(main, {
+  search: ['\n', '\r\n', '--boundary', '------------------------------1234'],
+  type: ['string', 'buffer'],
+  size: [1024, 64 * 1024],
+  millions: [0.1]
+});
+
+// Searches for a needle at the very end of the buffer.
+function main(conf) {
+  var iter = (conf.millions * 1e6) | 0;
+  var size = conf.size | 0;
+  var search = conf.search;
+  var filler = new Array(size - search.length + 1).join('x');
+  var buf = new Buffer(filler + search);
+  var needle = conf.type === 'buffer' ? new Buffer(search) : search;
+  var expected = size - search.length;
+
+  bench.start();
+  for (var i = 0; i < iter; i++) {
+    if (buf.indexOf(needle) !== expected)
+      throw new Error('unexpected result');
+  }
+  bench.end(iter / 1e6);
+}
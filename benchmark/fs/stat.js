@@ -0,0 +1,49 @@
+// Call fs.stat, fs.lstat or fs.fstat over and over again and count how
+// many stats per second we can do.  Measures the cost of turning a stat
+// result into a fs.Stats object more than the syscall itself.
+
+var common = require('../common.js');
+var fs = require('fs');
+
+var bench = common.createBenchmark(main, {
+  type: ['stat', 'lstat', 'fstat', 'statSync', 'lstatSync', 'fstatSync'],
+  dur: [5],
+  concurrent: [1, 10]
+});
+
+function main(conf) {
+  var type = conf.type;
+  var sync = /Sync$/.test(type);
+  var arg = /^fstat/.test(type) ? fs.openSync(__filename, 'r') : __filename;
+  var fn = fs[type];
+  var stats = 0;
+  var done = false;
+
+  bench.start();
+  setTimeout(function() {
+    done = true;
+    bench.end(stats);
+    if (typeof arg === 'number') fs.closeSync(arg);
+  }, +conf.dur * 1000);
+
+  if (sync)
+    return runSync();
+
+  var cur = +conf.concurrent;
+  while (cur--) fn(arg, afterStat);
+
+  function afterStat(er, st) {
+    if (er)
+      throw er;
+    stats++;
+    if (!done) fn(arg, afterStat);
+  }
+
+  // Do the sync calls in batches so the timer gets a chance to fire.
+  function runSync() {
+    for (var i = 0; i < 1000; i++)
+      fn(arg);
+    stats += 1000;
+    if (!done) setImmediate(runSync);
+  }
+}
@@ -0,0 +1,39 @@
+// I/O completion callbacks that each queue a nextTick, the pattern that
+// --batch-ticks optimizes.  Run with and without the flag to compare.
+var common = require('../common.js');
+var fs = require('fs');
+
+var bench = common.createBenchmark(main, {
+  concurrent: [1, 64],
+  thousands: [100]
+});
+
+function main(conf) {
+  var N = +conf.thousands * 1e3;
+  var started = 0;
+  var done = 0;
+
+  function next() {
+    if (started < N) {
+      started++;
+      fs.stat(__filename, onstat);
+    }
+  }
+
+  function onstat(err) {
+    if (err)
+      throw err;
+    process.nextTick(ontick);
+  }
+
+  function ontick() {
+    if (++done === N)
+      bench.end(N / 1e3);
+    else
+      next();
+  }
+
+  bench.start();
+  for (var i = 0; i < +conf.concurrent; i++)
+    next();
+}
@@ -0,0 +1,27 @@
+// Refresh the idle timeouts of many items, like net.Socket does on every
+// read and write.
+var common = require('../common.js');
+var timers = require('timers');
+
+var bench = common.createBenchmark(main, {
+  items: [1e3, 1e5],
+  thousands: [500]
+});
+
+function main(conf) {
+  var n = +conf.thousands * 1e3;
+  var items = new Array(+conf.items);
+  for (var i = 0; i < items.length; i++) {
+    items[i] = { _onTimeout: function() {} };
+    timers.enroll(items[i], 60000);
+    timers._unrefActive(items[i]);
+  }
+
+  bench.start();
+  for (var i = 0; i < n; i++)
+    timers._unrefActive(items[i % items.length]);
+  bench.end(n / 1e3);
+
+  for (var i = 0; i < items.length; i++)
+    timers.unenroll(items[i]);
+}
@@ -23,6 +23,7 @@ var buffer = process.binding('buffer');
 var smalloc = process.binding('smalloc');
 var util = require('util');
 var alloc = smalloc.alloc;
+var poolAlloc = smalloc.poolAlloc;
 var truncate = smalloc.truncate;
 var sliceOnto = smalloc.sliceOnto;
 var kMaxLength = smalloc.kMaxLength;
@@ -33,16 +34,11 @@ exports.SlowBuffer = SlowBuffer;
 exports.INSPECT_MAX_BYTES = 50;
 
 
+// Buffers up to half this size are carved out of slabs that are managed by
+// smalloc. Changing it only affects slabs that are created afterwards.
 Buffer.poolSize = 8 * 1024;
-var poolSize, poolOffset, allocPool;
-
-
-function createPool() {
-  poolSize = Buffer.poolSize;
-  allocPool = alloc({}, poolSize);
-  poolOffset = 0;
-}
-createPool();
+var poolSize = Buffer.poolSize;
+smalloc.setPoolSize(poolSize);
 
 
 function Buffer(subject, encoding) {
@@ -67,13 +63,9 @@ function Buffer(subject, encoding) {
   }
 
   if (this.length <= (Buffer.poolSize >>> 1) && this.length > 0) {
-    if (this.length > poolSize - poolOffset)
-      createPool();
-    this.parent = sliceOnto(allocPool,
-                            this,
-                            poolOffset,
-                            poolOffset + this.length);
-    poolOffset += this.length;
+    if (poolSize !== Buffer.poolSize)
+      smalloc.setPoolSize(poolSize = Buffer.poolSize);
+    poolAlloc(this, this.length);
   } else {
     alloc(this, this.length);
   }
@@ -181,13 +173,7 @@ Buffer.concat = function(list, length) {
     return list[0];
 
   var buffer = new Buffer(length);
-  var pos = 0;
-  for (var i = 0; i < list.length; i++) {
-    var buf = list[i];
-    buf.copy(buffer, pos);
-    pos += buf.length;
-  }
-
+  buffer.gather(list);
   return buffer;
 };
 
@@ -297,6 +283,24 @@ Buffer.prototype.compare = function compare(b) {
 };
 
 
+Buffer.prototype.indexOf = function indexOf(val, byteOffset) {
+  if (byteOffset > 0x7fffffff)
+    byteOffset = 0x7fffffff;
+  else if (byteOffset < -0x80000000)
+    byteOffset = -0x80000000;
+  byteOffset >>= 0;
+
+  if (util.isString(val))
+    return internal.indexOfString(this, val, byteOffset);
+  if (util.isBuffer(val))
+    return internal.indexOfBuffer(this, val, byteOffset);
+  if (util.isNumber(val))
+    return internal.indexOfNumber(this, val, byteOffset);
+
+  throw new TypeError('val must be string, number or Buffer');
+};
+
+
 // XXX remove in v0.13
 Buffer.prototype.get = util.deprecate(function get(offset) {
   offset = ~~offset;
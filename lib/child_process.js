@@ -323,14 +323,63 @@ function handleMessage(target, message, handle) {
   target.emit(eventName, message, handle);
 }
 
-function setupChannel(target, channel) {
+// With binary framing, every message is sent as a frame of a 32 bits big
+// endian payload length, a type byte and the payload. The pipe splits the
+// frames natively, and Buffers are sent as they are instead of as JSON.
+var kFrameHeaderSize = 5;
+var kFrameJSON = 0;
+var kFrameBuffer = 1;
+
+function writeFrame(channel, req, message, handle) {
+  var header = new Buffer(kFrameHeaderSize);
+  var payload;
+
+  if (util.isBuffer(message)) {
+    payload = message;
+    header.writeUInt32BE(payload.length, 0);
+    header[4] = kFrameBuffer;
+    // Keep it alive until it's written.
+    req.buffer = payload;
+  } else {
+    payload = JSON.stringify(message);
+    header.writeUInt32BE(Buffer.byteLength(payload), 0);
+    header[4] = kFrameJSON;
+  }
+
+  return channel.writev(req, [header, 'buffer', payload, 'utf8'], handle);
+}
+
+function setupChannel(target, channel, framing) {
   target._channel = channel;
   target._handleQueue = null;
 
+  var binary = framing === 'binary';
+  if (binary)
+    channel.setFramed();
+
+  var pendingHandle;
   var decoder = new StringDecoder('utf8');
   var jsonBuffer = '';
   channel.buffering = false;
-  channel.onread = function(nread, pool, recvHandle) {
+  channel.onread = function(nread, pool, recvHandle, type, partial) {
+    if (pool && binary) {
+      // A handle can arrive with the end of the frame that precedes the
+      // NODE_HANDLE message it belongs to.
+      if (recvHandle)
+        pendingHandle = recvHandle;
+
+      var message = type === kFrameBuffer ? pool : JSON.parse(pool.toString());
+      this.buffering = partial;
+
+      if (message && message.cmd === 'NODE_HANDLE') {
+        handleMessage(target, message, pendingHandle);
+        pendingHandle = undefined;
+      } else {
+        handleMessage(target, message, undefined);
+      }
+      return;
+    }
+
     // TODO(bnoordhuis) Check that nread > 0.
     if (pool) {
       jsonBuffer += decoder.write(pool);
@@ -473,8 +522,13 @@ function setupChannel(target, channel) {
     }
 
     var req = { oncomplete: nop };
-    var string = JSON.stringify(message) + '\n';
-    var err = channel.writeUtf8String(req, string, handle);
+    var err;
+    if (binary) {
+      err = writeFrame(channel, req, message, handle);
+    } else {
+      var string = JSON.stringify(message) + '\n';
+      err = channel.writeUtf8String(req, string, handle);
+    }
 
     if (err) {
       if (!swallowErrors)
@@ -577,12 +631,12 @@ exports.fork = function(modulePath /*, args, options*/) {
 };
 
 
-exports._forkChild = function(fd) {
+exports._forkChild = function(fd, framing) {
   // set process.send()
   var p = createPipe(true);
   p.open(fd);
   p.unref();
-  setupChannel(process, p);
+  setupChannel(process, p, framing);
 
   var refs = 0;
   process.on('newListener', function(name) {
@@ -985,7 +1039,8 @@ var spawn = exports.spawn = function(/*file, args, options*/) {
     envPairs: envPairs,
     stdio: options ? options.stdio : null,
     uid: options ? options.uid : null,
-    gid: options ? options.gid : null
+    gid: options ? options.gid : null,
+    framing: options ? options.framing : null
   });
 
   return child;
@@ -1110,9 +1165,17 @@ ChildProcess.prototype.spawn = function(options) {
   stdio = options.stdio = stdio.stdio;
 
   if (!util.isUndefined(ipc)) {
+    if (options.framing != null &&
+        options.framing !== 'json' &&
+        options.framing !== 'binary') {
+      throw new TypeError('framing must be "json" or "binary"');
+    }
+
     // Let child process know about opened IPC channel
     options.envPairs = options.envPairs || [];
     options.envPairs.push('NODE_CHANNEL_FD=' + ipcFd);
+    if (options.framing === 'binary')
+      options.envPairs.push('NODE_CHANNEL_FRAMING=binary');
   }
 
   this.spawnfile = options.file;
@@ -1182,7 +1245,7 @@ ChildProcess.prototype.spawn = function(options) {
   });
 
   // Add .send() method and start listening for IPC data
-  if (!util.isUndefined(ipc)) setupChannel(this, ipc);
+  if (!util.isUndefined(ipc)) setupChannel(this, ipc, options.framing);
 
   return err;
 };
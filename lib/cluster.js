@@ -296,7 +296,8 @@ function masterInit() {
       silent: cluster.settings.silent,
       execArgv: execArgv,
       gid: cluster.settings.gid,
-      uid: cluster.settings.uid
+      uid: cluster.settings.uid,
+      framing: cluster.settings.framing
     });
   }
 
@@ -37,7 +37,6 @@ var EventEmitter = require('events').EventEmitter;
 var Readable = Stream.Readable;
 var Writable = Stream.Writable;
 
-var kMinPoolSpace = 128;
 var kMaxLength = require('smalloc').kMaxLength;
 
 var O_APPEND = constants.O_APPEND || 0;
@@ -148,6 +147,38 @@ fs.Stats = function(
 // Create a C++ binding to the function which creates a Stats object.
 binding.FSInitialize(fs.Stats);
 
+// stat(), lstat() and fstat() store their results in a Float64Array rather
+// than building a Stats object in C++.  Synchronous calls share a single
+// array, asynchronous calls get their own because other JS code may run
+// between the request completing and the callback.
+var statValues = binding.statValues;
+var kStatValuesLength = statValues.length;
+
+function statsFromValues(values, offset) {
+  offset = offset | 0;
+  return new fs.Stats(values[offset + 0],
+                      values[offset + 1],
+                      values[offset + 2],
+                      values[offset + 3],
+                      values[offset + 4],
+                      values[offset + 5],
+                      isWindows ? undefined : values[offset + 6],
+                      values[offset + 7],
+                      values[offset + 8],
+                      isWindows ? undefined : values[offset + 9],
+                      values[offset + 10],
+                      values[offset + 11],
+                      values[offset + 12],
+                      values[offset + 13]);
+}
+
+function makeStatsCallback(values, cb) {
+  return function(err) {
+    if (err) return cb(err);
+    cb(null, statsFromValues(values));
+  };
+}
+
 fs.Stats.prototype._checkModeProperty = function(property) {
   return ((this.mode & constants.S_IFMT) === property);
 };
@@ -182,7 +213,7 @@ fs.Stats.prototype.isSocket = function() {
 
 fs.exists = function(path, callback) {
   if (!nullCheck(path, cb)) return;
-  binding.stat(pathModule._makeLong(path), cb);
+  binding.stat(pathModule._makeLong(path), cb, statValues);
   function cb(err, stats) {
     if (callback) callback(err ? false : true);
   }
@@ -191,7 +222,7 @@ fs.exists = function(path, callback) {
 fs.existsSync = function(path) {
   try {
     nullCheck(path);
-    binding.stat(pathModule._makeLong(path));
+    binding.stat(pathModule._makeLong(path), undefined, statValues);
     return true;
   } catch (e) {
     return false;
@@ -212,6 +243,22 @@ fs.readFile = function(path, options, callback_) {
   var encoding = options.encoding;
   assertEncoding(encoding);
 
+  var flag = options.flag || 'r';
+
+  // Open, read and close the file in a single threadpool job.
+  if (binding.readFile) {
+    if (!nullCheck(path, callback)) return;
+    binding.readFile(pathModule._makeLong(path),
+                     stringToFlags(flag),
+                     438 /*=0666*/,
+                     function(er, buffer) {
+      if (er) return callback(er);
+      if (encoding) buffer = buffer.toString(encoding);
+      callback(null, buffer);
+    });
+    return;
+  }
+
   // first, stat the file, so we know the size.
   var size;
   var buffer; // single buffer with file data
@@ -219,7 +266,6 @@ fs.readFile = function(path, options, callback_) {
   var pos = 0;
   var fd;
 
-  var flag = options.flag || 'r';
   fs.open(path, flag, 438 /*=0666*/, function(er, fd_) {
     if (er) return callback(er);
     fd = fd_;
@@ -310,6 +356,16 @@ fs.readFileSync = function(path, options) {
   assertEncoding(encoding);
 
   var flag = options.flag || 'r';
+
+  if (binding.readFile) {
+    nullCheck(path);
+    var buffer = binding.readFile(pathModule._makeLong(path),
+                                  stringToFlags(flag),
+                                  438 /*=0666*/);
+    if (encoding) buffer = buffer.toString(encoding);
+    return buffer;
+  }
+
   var fd = fs.openSync(path, flag, 438 /*=0666*/);
 
   var size;
@@ -680,10 +736,27 @@ fs.mkdirSync = function(path, mode) {
                        modeNum(mode, 511 /*=0777*/));
 };
 
-fs.readdir = function(path, callback) {
-  callback = makeCallback(callback);
+fs.readdir = function(path, options, callback) {
+  callback = makeCallback(arguments[arguments.length - 1]);
   if (!nullCheck(path, callback)) return;
-  binding.readdir(pathModule._makeLong(path), callback);
+
+  if (!util.isObject(options) || !options.types) {
+    binding.readdir(pathModule._makeLong(path), callback);
+    return;
+  }
+
+  // A directory walk that doesn't descend.
+  var names = [];
+  var types = [];
+  var walker = fs.walk(path, { depth: 0 });
+  walker.on('entries', function(paths, entryTypes) {
+    names.push.apply(names, paths);
+    types.push.apply(types, entryTypes);
+  });
+  walker.on('error', callback);
+  walker.on('end', function() {
+    callback(null, names, types);
+  });
 };
 
 fs.readdirSync = function(path) {
@@ -691,34 +764,275 @@ fs.readdirSync = function(path) {
   return binding.readdir(pathModule._makeLong(path));
 };
 
+fs.walk = function(path, options) {
+  return new Walker(path, options || {});
+};
+
+function Walker(path, options) {
+  EventEmitter.call(this);
+
+  var depth = options.depth;
+  if (util.isUndefined(depth) || depth === Infinity)
+    depth = -1;
+  else if (!util.isNumber(depth) || depth < 0)
+    throw new TypeError('depth must be a positive number');
+  else
+    depth = Math.floor(depth);
+
+  var exclude = options.exclude || [];
+  if (!util.isArray(exclude))
+    throw new TypeError('exclude must be an array');
+
+  var self = this;
+  this._stopped = false;
+
+  if (!nullCheck(path, function(err) { self.emit('error', err); }))
+    return;
+
+  if (binding.walk) {
+    binding.walk(pathModule._makeLong(path), depth, exclude, onentries);
+  } else {
+    walkOneByOne(this, path, depth, exclude);
+  }
+
+  function onentries(err, paths, types, done) {
+    if (self._stopped)
+      return false;
+    if (paths.length > 0)
+      self.emit('entries', paths, types);
+    if (err)
+      self.emit('error', err);
+    else if (done && !self._stopped)
+      self.emit('end');
+    return !self._stopped;
+  }
+}
+util.inherits(Walker, EventEmitter);
+
+Walker.prototype.stop = function() {
+  this._stopped = true;
+};
+
+// Windows doesn't have the native walker, lstat every entry instead.
+function walkOneByOne(walker, root, depth, exclude) {
+  var queue = [{ path: '', depth: 0 }];
+  next();
+
+  function next() {
+    if (walker._stopped)
+      return;
+
+    var dir = queue.shift();
+    if (!dir)
+      return walker.emit('end');
+
+    fs.readdir(pathModule.join(root, dir.path), function(err, names) {
+      if (walker._stopped)
+        return;
+      if (err)
+        return walker.emit('error', err);
+
+      var paths = names.filter(function(name) {
+        return exclude.indexOf(name) === -1;
+      }).map(function(name) {
+        return pathModule.join(dir.path, name);
+      });
+      var types = new Array(paths.length);
+      var pending = paths.length;
+
+      if (pending === 0)
+        return onstats();
+
+      paths.forEach(function(path, i) {
+        fs.lstat(pathModule.join(root, path), function(err, stats) {
+          types[i] = err ? 0 : stats.mode & constants.S_IFMT;
+          if (--pending === 0)
+            onstats();
+        });
+      });
+
+      function onstats() {
+        if (walker._stopped)
+          return;
+        for (var i = 0; i < paths.length; i++) {
+          if (types[i] !== constants.S_IFDIR)
+            continue;
+          if (depth < 0 || dir.depth < depth)
+            queue.push({ path: paths[i], depth: dir.depth + 1 });
+        }
+        if (paths.length > 0)
+          walker.emit('entries', paths, types);
+        next();
+      }
+    });
+  }
+}
+
 fs.fstat = function(fd, callback) {
-  binding.fstat(fd, makeCallback(callback));
+  var values = new Float64Array(kStatValuesLength);
+  callback = makeStatsCallback(values, makeCallback(callback));
+  binding.fstat(fd, callback, values);
 };
 
 fs.lstat = function(path, callback) {
   callback = makeCallback(callback);
   if (!nullCheck(path, callback)) return;
-  binding.lstat(pathModule._makeLong(path), callback);
+  var values = new Float64Array(kStatValuesLength);
+  binding.lstat(pathModule._makeLong(path),
+                makeStatsCallback(values, callback),
+                values);
 };
 
 fs.stat = function(path, callback) {
   callback = makeCallback(callback);
   if (!nullCheck(path, callback)) return;
-  binding.stat(pathModule._makeLong(path), callback);
+  var values = new Float64Array(kStatValuesLength);
+  binding.stat(pathModule._makeLong(path),
+               makeStatsCallback(values, callback),
+               values);
 };
 
 fs.fstatSync = function(fd) {
-  return binding.fstat(fd);
+  binding.fstat(fd, undefined, statValues);
+  return statsFromValues(statValues);
 };
 
 fs.lstatSync = function(path) {
   nullCheck(path);
-  return binding.lstat(pathModule._makeLong(path));
+  binding.lstat(pathModule._makeLong(path), undefined, statValues);
+  return statsFromValues(statValues);
 };
 
 fs.statSync = function(path) {
   nullCheck(path);
-  return binding.stat(pathModule._makeLong(path));
+  binding.stat(pathModule._makeLong(path), undefined, statValues);
+  return statsFromValues(statValues);
+};
+
+// Paths per threadpool job is at least this, and at most this many jobs are
+// used for a single fs.statMany() call.
+var kStatManyMinBatch = 1024;
+var kStatManyMaxJobs = 4;
+
+fs.statMany = function(paths, callback) {
+  callback = makeCallback(callback);
+  if (!util.isArray(paths))
+    throw new TypeError('paths must be an array');
+
+  var count = paths.length;
+  var longPaths = new Array(count);
+  for (var i = 0; i < count; i++) {
+    if (!util.isString(paths[i]))
+      throw new TypeError('path must be a string');
+    if (!nullCheck(paths[i], callback)) return;
+    longPaths[i] = pathModule._makeLong(paths[i]);
+  }
+
+  if (count === 0) {
+    process.nextTick(function() {
+      callback(null, []);
+    });
+    return;
+  }
+
+  if (!binding.statMany)
+    return statManyOneByOne(paths, callback);
+
+  var values = new Float64Array(count * kStatValuesLength);
+  var errors = new Int32Array(count);
+  var jobs = Math.min(kStatManyMaxJobs, Math.ceil(count / kStatManyMinBatch));
+  var batch = Math.ceil(count / jobs);
+  var pending = jobs;
+
+  for (var start = 0; start < count; start += batch) {
+    var end = Math.min(count, start + batch);
+    binding.statMany(longPaths.slice(start, end),
+                     values.subarray(start * kStatValuesLength,
+                                     end * kStatValuesLength),
+                     errors.subarray(start, end),
+                     oncomplete);
+  }
+
+  function oncomplete() {
+    if (--pending > 0) return;
+    var results = new Array(count);
+    for (var i = 0; i < count; i++) {
+      if (errors[i] === 0)
+        results[i] = statsFromValues(values, i * kStatValuesLength);
+      else
+        results[i] = statManyError(errors[i], paths[i]);
+    }
+    callback(null, results);
+  }
+};
+
+// Same error as fs.stat() reports.
+function statManyError(err, path) {
+  var code = process.binding('uv').errname(err);
+  var e = new Error(code + ', stat \'' + path + '\'');
+  e.errno = err;
+  e.code = code;
+  e.path = path;
+  return e;
+}
+
+function statManyOneByOne(paths, callback) {
+  var results = new Array(paths.length);
+  var pending = paths.length;
+  paths.forEach(function(path, i) {
+    fs.stat(path, function(err, stats) {
+      results[i] = err || stats;
+      if (--pending === 0) callback(null, results);
+    });
+  });
+}
+
+fs.copyFile = function(src, dest, flag, callback) {
+  callback = makeCallback(arguments[arguments.length - 1]);
+  flag = util.isString(flag) ? flag : 'w';
+  if (!nullCheck(src, callback) || !nullCheck(dest, callback)) return;
+
+  if (binding.copyFile) {
+    binding.copyFile(pathModule._makeLong(src),
+                     pathModule._makeLong(dest),
+                     stringToFlags(flag),
+                     callback);
+    return;
+  }
+
+  var done = false;
+  var readStream = fs.createReadStream(src);
+  var writeStream = fs.createWriteStream(dest, { flags: flag });
+  readStream.on('error', onerror);
+  writeStream.on('error', onerror);
+  writeStream.on('close', function() {
+    if (!done) callback(null);
+    done = true;
+  });
+  readStream.pipe(writeStream);
+
+  function onerror(er) {
+    if (done) return;
+    done = true;
+    readStream.destroy();
+    writeStream.destroy();
+    callback(er);
+  }
+};
+
+fs.copyFileSync = function(src, dest, flag) {
+  flag = util.isString(flag) ? flag : 'w';
+  nullCheck(src);
+  nullCheck(dest);
+
+  if (binding.copyFile) {
+    binding.copyFile(pathModule._makeLong(src),
+                     pathModule._makeLong(dest),
+                     stringToFlags(flag));
+    return;
+  }
+
+  fs.writeFileSync(dest, fs.readFileSync(src), { flag: flag });
 };
 
 fs.readlink = function(path, callback) {
@@ -974,6 +1288,21 @@ fs.writeFile = function(path, data, options, callback) {
   assertEncoding(options.encoding);
 
   var flag = options.flag || 'w';
+
+  // Open, write and close the file in a single threadpool job.
+  if (binding.writeFile) {
+    if (!nullCheck(path, callback)) return;
+    var buffer = util.isBuffer(data) ? data : new Buffer('' + data,
+        options.encoding || 'utf8');
+    binding.writeFile(pathModule._makeLong(path),
+                      buffer,
+                      stringToFlags(flag),
+                      modeNum(options.mode, 438 /*=0666*/),
+                      !!options.fsync,
+                      callback);
+    return;
+  }
+
   fs.open(path, flag, options.mode, function(openErr, fd) {
     if (openErr) {
       if (callback) callback(openErr);
@@ -998,10 +1327,21 @@ fs.writeFileSync = function(path, data, options) {
   assertEncoding(options.encoding);
 
   var flag = options.flag || 'w';
-  var fd = fs.openSync(path, flag, options.mode);
   if (!util.isBuffer(data)) {
     data = new Buffer('' + data, options.encoding || 'utf8');
   }
+
+  if (binding.writeFile) {
+    nullCheck(path);
+    binding.writeFile(pathModule._makeLong(path),
+                      data,
+                      stringToFlags(flag),
+                      modeNum(options.mode, 438 /*=0666*/),
+                      !!options.fsync);
+    return;
+  }
+
+  var fd = fs.openSync(path, flag, options.mode);
   var written = 0;
   var length = data.length;
   var position = /a/.test(flag) ? null : 0;
@@ -1057,6 +1397,11 @@ function FSWatcher() {
     if (status < 0) {
       self._handle.close();
       self.emit('error', errnoException(status, 'watch'));
+    } else if (util.isArray(event)) {
+      // Coalesced changes of a recursive watch on Linux.
+      self.emit('changes', event, filename);
+      for (var i = 0; i < event.length; i++)
+        self.emit('change', event[i], filename[i]);
     } else {
       self.emit('change', event, filename);
     }
@@ -1064,11 +1409,15 @@ function FSWatcher() {
 }
 util.inherits(FSWatcher, EventEmitter);
 
-FSWatcher.prototype.start = function(filename, persistent, recursive) {
+FSWatcher.prototype.start = function(filename,
+                                     persistent,
+                                     recursive,
+                                     coalesce) {
   nullCheck(filename);
   var err = this._handle.start(pathModule._makeLong(filename),
                                persistent,
-                               recursive);
+                               recursive,
+                               coalesce);
   if (err) {
     this._handle.close();
     throw errnoException(err, 'watch');
@@ -1095,9 +1444,16 @@ fs.watch = function(filename) {
 
   if (util.isUndefined(options.persistent)) options.persistent = true;
   if (util.isUndefined(options.recursive)) options.recursive = false;
+  if (util.isUndefined(options.coalesce)) options.coalesce = 0;
+
+  if (!util.isNumber(options.coalesce) || options.coalesce < 0)
+    throw new TypeError('coalesce must be a positive number');
 
   watcher = new FSWatcher();
-  watcher.start(filename, options.persistent, options.recursive);
+  watcher.start(filename,
+                options.persistent,
+                options.recursive,
+                options.coalesce);
 
   if (listener) {
     watcher.addListener('change', listener);
@@ -1443,12 +1799,11 @@ fs.realpath = function realpath(p, cache, cb) {
 
 
 
-var pool;
-
-function allocNewPool(poolSize) {
-  pool = new Buffer(poolSize);
-  pool.used = 0;
-}
+// fs.ReadStream reads into Buffers from a pool in smalloc. Every read gets a
+// chunk of its own that goes back to the pool when the Buffer is collected,
+// or right away when a short read is copied out of it.
+var readPoolAlloc = process.binding('smalloc').readPoolAlloc;
+var disposeReadBuffer = process.binding('smalloc').dispose;
 
 
 
@@ -1537,18 +1892,7 @@ ReadStream.prototype._read = function(n) {
   if (this.destroyed)
     return;
 
-  if (!pool || pool.length - pool.used < kMinPoolSpace) {
-    // discard the old pool.
-    pool = null;
-    allocNewPool(this._readableState.highWaterMark);
-  }
-
-  // Grab another reference to the pool in the case that while we're
-  // in the thread pool another read() finishes up the pool, and
-  // allocates a new one.
-  var thisPool = pool;
-  var toRead = Math.min(pool.length - pool.used, n);
-  var start = pool.used;
+  var toRead = Math.min(this._readableState.highWaterMark, n);
 
   if (!util.isUndefined(this.pos))
     toRead = Math.min(this.end - this.pos + 1, toRead);
@@ -1560,23 +1904,35 @@ ReadStream.prototype._read = function(n) {
 
   // the actual read.
   var self = this;
-  fs.read(this.fd, pool, pool.used, toRead, this.pos, onread);
+  var buffer = readPoolAlloc(toRead);
+  fs.read(this.fd, buffer, 0, toRead, this.pos, onread);
 
-  // move the pool positions, and internal position for reading.
+  // move the internal position for reading.
   if (!util.isUndefined(this.pos))
     this.pos += toRead;
-  pool.used += toRead;
 
   function onread(er, bytesRead) {
     if (er) {
+      disposeReadBuffer(buffer);
       if (self.autoClose) {
         self.destroy();
       }
       self.emit('error', er);
     } else {
       var b = null;
-      if (bytesRead > 0)
-        b = thisPool.slice(start, start + bytesRead);
+      if (bytesRead === toRead) {
+        b = buffer;
+      } else if (bytesRead > toRead >>> 1) {
+        b = buffer.slice(0, bytesRead);
+      } else {
+        // Mostly empty, copy the data out so that the consumer doesn't keep
+        // the whole chunk alive.
+        if (bytesRead > 0) {
+          b = new Buffer(bytesRead);
+          buffer.copy(b, 0, 0, bytesRead);
+        }
+        disposeReadBuffer(buffer);
+      }
 
       self.push(b);
     }
@@ -23,6 +23,7 @@ var NativeModule = require('native_module');
 var util = NativeModule.require('util');
 var runInThisContext = require('vm').runInThisContext;
 var runInNewContext = require('vm').runInNewContext;
+var Script = require('vm').Script;
 var assert = require('assert').ok;
 var fs = NativeModule.require('fs');
 
@@ -52,6 +53,9 @@ module.exports = Module;
 // Set the environ variable NODE_MODULE_CONTEXTS=1 to make node load all
 // modules in their own context.
 Module._contextLoad = (+process.env['NODE_MODULE_CONTEXTS'] > 0);
+// Set the environ variable NODE_CODE_CACHE_DIR to a writable directory to
+// make node keep V8's compile data for loaded modules there between runs.
+Module._codeCacheDir = process.env['NODE_CODE_CACHE_DIR'] || null;
 Module._cache = {};
 Module._pathCache = {};
 Module._extensions = {};
@@ -440,7 +444,7 @@ Module.prototype._compile = function(content, filename) {
   // create wrapper function
   var wrapper = Module.wrap(content);
 
-  var compiledWrapper = runInThisContext(wrapper, { filename: filename });
+  var compiledWrapper = compileWrapper(wrapper, filename);
   if (global.v8debug) {
     if (!resolvedArgv) {
       // we enter the repl if we're not given a filename argument.
@@ -472,6 +476,122 @@ function stripBOM(content) {
 }
 
 
+// Each module has one code cache file, named after a hash of its filename.
+// The file starts with the cache key, prefixed by its length as a UInt32LE:
+//   [key length][key][cached data]
+// The key covers everything that invalidates the cached data, and the
+// filename to catch hash collisions.  When it doesn't match, the module is
+// compiled from scratch and the file is overwritten.
+function codeCacheKey(filename) {
+  var stat = fs.statSync(filename);
+  return [filename,
+          stat.mtime.getTime(),
+          stat.size,
+          process.versions.v8].join('\0');
+}
+
+
+function codeCachePath(filename) {
+  var hash = 0x811c9dc5;  // 32 bits FNV-1a
+  for (var i = 0; i < filename.length; i++) {
+    hash ^= filename.charCodeAt(i);
+    hash = Math.imul(hash, 0x01000193);
+  }
+  return path.join(Module._codeCacheDir, (hash >>> 0).toString(16) + '.cache');
+}
+
+
+function readCodeCache(cachePath, key) {
+  try {
+    var buf = fs.readFileSync(cachePath);
+  } catch (e) {
+    return undefined;
+  }
+  if (buf.length < 4)
+    return undefined;
+  var keyLength = buf.readUInt32LE(0);
+  if (4 + keyLength > buf.length ||
+      buf.toString('utf8', 4, 4 + keyLength) !== key) {
+    return undefined;
+  }
+  return buf.slice(4 + keyLength);
+}
+
+
+// Creates |dir| and its missing parents.
+function mkdirpSync(dir) {
+  try {
+    fs.mkdirSync(dir);
+  } catch (e) {
+    if (e.code === 'EEXIST')
+      return;
+    if (e.code !== 'ENOENT' || path.dirname(dir) === dir)
+      throw e;
+    mkdirpSync(path.dirname(dir));
+    fs.mkdirSync(dir);
+  }
+}
+
+
+function writeCodeCache(cachePath, key, data) {
+  var keyLength = Buffer.byteLength(key);
+  var buf = new Buffer(4 + keyLength + data.length);
+  buf.writeUInt32LE(keyLength, 0);
+  buf.write(key, 4);
+  data.copy(buf, 4 + keyLength);
+  // Write to a temporary file and rename it so that concurrently starting
+  // processes never see a partially written cache file.
+  var tmpPath = cachePath + '.' + process.pid;
+  try {
+    try {
+      fs.writeFileSync(tmpPath, buf);
+    } catch (e) {
+      if (e.code !== 'ENOENT')
+        throw e;
+      mkdirpSync(Module._codeCacheDir);
+      fs.writeFileSync(tmpPath, buf);
+    }
+    fs.renameSync(tmpPath, cachePath);
+  } catch (e) {
+    debug('cannot write code cache %s: %s', cachePath, e.message);
+  }
+}
+
+
+// Compile the module wrapper, going through the code cache if enabled.
+// Caching is best effort, errors just mean the module is compiled from
+// scratch.
+function compileWrapper(wrapper, filename) {
+  if (!Module._codeCacheDir)
+    return runInThisContext(wrapper, { filename: filename });
+
+  try {
+    var key = codeCacheKey(filename);
+  } catch (e) {
+    return runInThisContext(wrapper, { filename: filename });
+  }
+  var cachePath = codeCachePath(filename);
+  var cachedData = readCodeCache(cachePath, key);
+  var script = new Script(wrapper, {
+    filename: filename,
+    cachedData: cachedData,
+    produceCachedData: !cachedData
+  });
+
+  if (script.cachedDataRejected) {
+    debug('code cache rejected %s', cachePath);
+    try {
+      fs.unlinkSync(cachePath);
+    } catch (e) {
+    }
+  } else if (script.cachedData) {
+    writeCodeCache(cachePath, key, script.cachedData);
+  }
+
+  return script.runInThisContext();
+}
+
+
 // Native extension for .js
 Module._extensions['.js'] = function(module, filename) {
   var content = fs.readFileSync(filename, 'utf8');
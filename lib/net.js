@@ -632,6 +632,9 @@ Socket.prototype._writeGeneric = function(writev, data, encoding, cb) {
     return false;
   }
 
+  if (!writev && data._sendFile)
+    return this._sendFileGeneric(data._sendFile, cb);
+
   var req = { oncomplete: afterWrite, async: false };
   var err;
 
@@ -674,6 +677,9 @@ Socket.prototype._writeGeneric = function(writev, data, encoding, cb) {
 
 
 Socket.prototype._writev = function(chunks, cb) {
+  for (var i = 0; i < chunks.length; i++)
+    if (chunks[i].chunk._sendFile)
+      return writeSeries(this, chunks, cb);
   this._writeGeneric(true, chunks, '', cb);
 };
 
@@ -682,6 +688,84 @@ Socket.prototype._write = function(data, encoding, cb) {
   this._writeGeneric(false, data, encoding, cb);
 };
 
+
+// File transfers can't be part of a writev, write the batch one by one.
+function writeSeries(self, chunks, cb) {
+  var i = 0;
+  next();
+
+  function next(err) {
+    if (err)
+      return cb(err);
+    if (i === chunks.length)
+      return cb();
+    var entry = chunks[i++];
+    self._writeGeneric(false, entry.chunk, entry.encoding, next);
+  }
+}
+
+
+// Sends `length` bytes of the file `fd`, starting at `offset`.  It's queued
+// like any other write, so it goes out in order with the writes around it.
+Socket.prototype.sendFile = function(fd, offset, length, cb) {
+  if (!util.isNumber(fd) || fd < 0 || fd !== (fd | 0))
+    throw new TypeError('fd must be a file descriptor');
+  if (!util.isNumber(offset) || offset < 0 || !isFinite(offset))
+    throw new TypeError('offset must be a positive number');
+  if (!util.isNumber(length) || length < 0 || !isFinite(length))
+    throw new TypeError('length must be a positive number');
+
+  var chunk = new Buffer(0);
+  chunk._sendFile = { fd: fd, offset: offset, length: length };
+  return stream.Duplex.prototype.write.call(this, chunk, cb);
+};
+
+
+Socket.prototype._sendFileGeneric = function(file, cb) {
+  var req = { oncomplete: afterWrite, async: false };
+  var err = uv.UV_ENOTSUP;
+
+  if (this._handle.sendFile)
+    err = this._handle.sendFile(req, file.fd, file.offset, file.length);
+
+  if (err === uv.UV_ENOTSUP || err === uv.UV_EBUSY)
+    return sendFileSlow(this, file, cb);
+
+  if (err)
+    return this._destroy(errnoException(err, 'sendfile'), cb);
+
+  this._bytesDispatched += req.bytes;
+  req.cb = cb;
+};
+
+
+// Reads the file into buffers and writes those, for streams that can't send
+// files directly (TLS, pipes) or when sendfile(2) isn't available.
+function sendFileSlow(self, file, cb) {
+  var fs = require('fs');
+  var offset = file.offset;
+  var remaining = file.length;
+  next();
+
+  function next(err) {
+    if (err)
+      return cb(err);
+    if (remaining === 0)
+      return cb();
+
+    var buffer = new Buffer(Math.min(remaining, 65536));
+    fs.read(file.fd, buffer, 0, buffer.length, offset, function(err, nread) {
+      if (!err && nread === 0)
+        err = errnoException(uv.UV_EOF, 'sendfile');
+      if (err)
+        return self._destroy(err, cb);
+      offset += nread;
+      remaining -= nread;
+      self._writeGeneric(false, buffer.slice(0, nread), 'buffer', next);
+    });
+  }
+}
+
 function createWriteReq(req, handle, data, encoding) {
   switch (encoding) {
     case 'buffer':
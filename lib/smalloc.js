@@ -27,6 +27,9 @@ exports.alloc = alloc;
 exports.copyOnto = smalloc.copyOnto;
 exports.dispose = dispose;
 exports.hasExternalData = smalloc.hasExternalData;
+exports.poolStats = smalloc.poolStats;
+exports.readPoolStats = smalloc.readPoolStats;
+exports.setReadPoolLimit = setReadPoolLimit;
 
 // don't allow kMaxLength to accidentally be overwritten. it's a lot less
 // apparent when a primitive is accidentally changed.
@@ -88,3 +91,11 @@ function dispose(obj) {
 
   smalloc.dispose(obj);
 }
+
+
+function setReadPoolLimit(n) {
+  if (!util.isNumber(n) || n < 0 || n > kMaxLength)
+    throw new RangeError('n must be between 0 and kMaxLength');
+
+  smalloc.setReadPoolLimit(n);
+}
@@ -58,6 +58,9 @@ delete tracing._unloadAsyncQueue;
 // key = time in milliseconds
 // value = list
 var lists = {};
+// Same as lists, but for items that shouldn't keep the loop alive, see
+// _unrefActive().  The timers backing these lists are unref'd.
+var unrefedLists = {};
 
 // Make Timer as monomorphic as possible.
 Timer.prototype._asyncQueue = undefined;
@@ -66,24 +69,27 @@ Timer.prototype._asyncFlags = 0;
 
 // the main function - creates lists on demand and the watchers associated
 // with them.
-function insert(item, msecs) {
+function insert(item, msecs, unrefed) {
   item._idleStart = Timer.now();
   item._idleTimeout = msecs;
 
   if (msecs < 0) return;
 
+  var map = unrefed ? unrefedLists : lists;
   var list;
 
-  if (lists[msecs]) {
-    list = lists[msecs];
+  if (map[msecs]) {
+    list = map[msecs];
   } else {
     list = new Timer();
     list.start(msecs, 0);
+    if (unrefed) list.unref();
 
     L.init(list);
 
-    lists[msecs] = list;
+    map[msecs] = list;
     list.msecs = msecs;
+    list.unrefed = unrefed;
     list[kOnTimeout] = listOnTimeout;
   }
 
@@ -155,21 +161,32 @@ function listOnTimeout() {
   debug('%d list empty', msecs);
   assert(L.isEmpty(list));
   list.close();
-  delete lists[msecs];
+  if (list.unrefed)
+    delete unrefedLists[msecs];
+  else
+    delete lists[msecs];
 }
 
 
-var unenroll = exports.unenroll = function(item) {
-  L.remove(item);
-
-  var list = lists[item._idleTimeout];
+function closeIfEmpty(map, msecs) {
+  var list = map[msecs];
   // if empty then stop the watcher
-  debug('unenroll');
   if (list && L.isEmpty(list)) {
     debug('unenroll: list empty');
     list.close();
-    delete lists[item._idleTimeout];
+    delete map[msecs];
   }
+}
+
+
+var unenroll = exports.unenroll = function(item) {
+  L.remove(item);
+
+  // The item doesn't know which list it was on, check both.
+  debug('unenroll');
+  closeIfEmpty(lists, item._idleTimeout);
+  closeIfEmpty(unrefedLists, item._idleTimeout);
+
   // if active is called later, then we want to make sure not to insert again
   item._idleTimeout = -1;
 };
@@ -198,7 +215,7 @@ exports.active = function(item) {
   if (msecs >= 0) {
     var list = lists[msecs];
     if (!list || L.isEmpty(list)) {
-      insert(item, msecs);
+      insert(item, msecs, false);
     } else {
       item._idleStart = Timer.now();
       L.append(list, item);
@@ -462,58 +479,11 @@ exports.clearImmediate = function(immediate) {
 
 
 // Internal APIs that need timeouts should use timers._unrefActive instead of
-// timers.active as internal timeouts shouldn't hold the loop open
-
-var unrefList, unrefTimer;
-
-
-function unrefTimeout() {
-  var now = Timer.now();
-
-  debug('unrefTimer fired');
-
-  var diff, domain, first, hasQueue, threw;
-  while (first = L.peek(unrefList)) {
-    diff = now - first._idleStart;
-
-    if (diff < first._idleTimeout) {
-      diff = first._idleTimeout - diff;
-      unrefTimer.start(diff, 0);
-      unrefTimer.when = now + diff;
-      debug('unrefTimer rescheudling for later');
-      return;
-    }
-
-    L.remove(first);
-
-    domain = first.domain;
-
-    if (!first._onTimeout) continue;
-    if (domain && domain._disposed) continue;
-    hasQueue = !!first._asyncQueue;
-
-    try {
-      if (hasQueue)
-        loadAsyncQueue(first);
-      if (domain) domain.enter();
-      threw = true;
-      debug('unreftimer firing timeout');
-      first._onTimeout();
-      threw = false;
-      if (domain)
-        domain.exit();
-      if (hasQueue)
-        unloadAsyncQueue(first);
-    } finally {
-      if (threw) process.nextTick(unrefTimeout);
-    }
-  }
-
-  debug('unrefList is empty');
-  unrefTimer.when = -1;
-}
-
-
+// timers.active as internal timeouts shouldn't hold the loop open.
+//
+// Items are kept in per-duration lists like the ones above, so refreshing
+// a timeout is a constant time append to the tail of its list no matter
+// how many other items are pending.
 exports._unrefActive = function(item) {
   var msecs = item._idleTimeout;
   if (!msecs || msecs < 0) return;
@@ -521,55 +491,11 @@ exports._unrefActive = function(item) {
 
   L.remove(item);
 
-  if (!unrefList) {
-    debug('unrefList initialized');
-    unrefList = {};
-    L.init(unrefList);
-
-    debug('unrefTimer initialized');
-    unrefTimer = new Timer();
-    unrefTimer.unref();
-    unrefTimer.when = -1;
-    unrefTimer[kOnTimeout] = unrefTimeout;
-  }
-
-  var now = Timer.now();
-  item._idleStart = now;
-
-  if (L.isEmpty(unrefList)) {
-    debug('unrefList empty');
-    L.append(unrefList, item);
-
-    unrefTimer.start(msecs, 0);
-    unrefTimer.when = now + msecs;
-    debug('unrefTimer scheduled');
-    return;
-  }
-
-  var when = now + msecs;
-
-  debug('unrefList find where we can insert');
-
-  var cur, them;
-
-  for (cur = unrefList._idlePrev; cur != unrefList; cur = cur._idlePrev) {
-    them = cur._idleStart + cur._idleTimeout;
-
-    if (when < them) {
-      debug('unrefList inserting into middle of list');
-
-      L.append(cur, item);
-
-      if (unrefTimer.when > when) {
-        debug('unrefTimer is scheduled to fire too late, reschedule');
-        unrefTimer.start(msecs, 0);
-        unrefTimer.when = when;
-      }
-
-      return;
-    }
+  var list = unrefedLists[msecs];
+  if (!list || L.isEmpty(list)) {
+    insert(item, msecs, true);
+  } else {
+    item._idleStart = Timer.now();
+    L.append(list, item);
   }
-
-  debug('unrefList append to end');
-  L.append(unrefList, item);
 };
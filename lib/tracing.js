@@ -31,6 +31,8 @@ exports._nodeInitialization = function nodeInitialization(pobj) {
 
   // Finish setting up the v8 Object.
   v8.getHeapStatistics = v8binding.getHeapStatistics;
+  v8.startGCStatistics = v8binding.startGarbageCollectionStats;
+  v8.stopGCStatistics = v8binding.stopGarbageCollectionStats;
 
   // Part of the AsyncListener setup to share objects/callbacks with the
   // native layer.
@@ -68,6 +70,32 @@ v8.on('removeListener', function(name) {
 });
 
 
+// Reads the counters that src/node_v8.cc accumulates while GC statistics
+// are enabled.  Nothing crosses into JS while the GC runs.
+v8.getGCStatistics = function getGCStatistics() {
+  return {
+    scavenge: gcTypeStatistics(v8binding.kGCScavenge),
+    mark_sweep_compact: gcTypeStatistics(v8binding.kGCMarkSweepCompact)
+  };
+};
+
+
+function gcTypeStatistics(type) {
+  var fields = v8binding.gcStats;
+  var base = type * v8binding.kGCFieldsPerType;
+  var histogram = new Array(v8binding.kGCPauseBuckets);
+  for (var i = 0; i < histogram.length; i++)
+    histogram[i] = fields[base + v8binding.kGCPause + i];
+  return {
+    count: fields[base + v8binding.kGCCount],
+    pause_total: fields[base + v8binding.kGCPauseTotal],
+    pause_max: fields[base + v8binding.kGCPauseMax],
+    reclaimed: fields[base + v8binding.kGCReclaimed],
+    pause_histogram: histogram
+  };
+}
+
+
 // AsyncListener
 
 // new Array() is used here because it is more efficient for sparse
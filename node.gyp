@@ -87,6 +87,7 @@
       ],
 
       'sources': [
+        'src/async-wrap.cc',
         'src/fs_event_wrap.cc',
         'src/cares_wrap.cc',
         'src/handle_wrap.cc',
@@ -263,13 +264,24 @@
         } ],
         [ 'node_use_perfctr=="true"', {
           'defines': [ 'HAVE_PERFCTR=1' ],
-          'dependencies': [ 'node_perfctr' ],
           'sources': [
-            'src/node_win32_perfctr_provider.h',
-            'src/node_win32_perfctr_provider.cc',
             'src/node_counters.cc',
             'src/node_counters.h',
-            'tools/msvs/genfiles/node_perfctr_provider.rc',
+          ],
+          'conditions': [
+            [ 'OS=="win"', {
+              'dependencies': [ 'node_perfctr' ],
+              'sources': [
+                'src/node_win32_perfctr_provider.h',
+                'src/node_win32_perfctr_provider.cc',
+                'tools/msvs/genfiles/node_perfctr_provider.rc',
+              ]
+            }, {
+              'sources': [
+                'src/node_linux_perfctr_provider.h',
+                'src/node_linux_perfctr_provider.cc',
+              ]
+            } ],
           ]
         } ],
         [ 'v8_postmortem_support=="true"', {
@@ -40,7 +40,15 @@ inline AsyncWrap::AsyncWrap(Environment* env,
                             ProviderType provider)
     : BaseObject(env, object),
       async_flags_(NO_OPTIONS),
-      provider_type_(provider) {
+      provider_type_(provider),
+      created_(0) {
+  Environment::AsyncStats* async_stats = env->async_stats();
+  if (async_stats->enabled()) {
+    async_flags_ |= HAS_ASYNC_STATS;
+    created_ = uv_hrtime();
+    async_stats->OnCreate(provider_index());
+  }
+
   if (!env->has_async_listener())
     return;
 
@@ -57,6 +65,10 @@ inline AsyncWrap::AsyncWrap(Environment* env,
 
 
 inline AsyncWrap::~AsyncWrap() {
+  // Wraps are counted for their whole life time, even if the stats have
+  // been disabled since, so that created - destroyed is the live count.
+  if (async_flags_ & HAS_ASYNC_STATS)
+    env()->async_stats()->OnDestroy(provider_index());
 }
 
 inline uint32_t AsyncWrap::provider_type() const {
@@ -64,6 +76,20 @@ inline uint32_t AsyncWrap::provider_type() const {
 }
 
 
+inline int AsyncWrap::ProviderIndex(uint32_t provider_type) {
+  int index = 0;
+  while ((provider_type >> index) > 1)
+    index += 1;
+  assert(index < Environment::AsyncStats::kProviderCount);
+  return index;
+}
+
+
+inline int AsyncWrap::provider_index() const {
+  return ProviderIndex(provider_type_);
+}
+
+
 inline bool AsyncWrap::has_async_listener() {
   return async_flags_ & HAS_ASYNC_LISTENER;
 }
@@ -134,7 +160,7 @@ inline v8::Handle<v8::Value> AsyncWrap::MakeDomainCallback(
 
   Environment::TickInfo* tick_info = env()->tick_info();
 
-  if (tick_info->in_tick()) {
+  if (tick_info->in_tick() || tick_info->in_batch()) {
     return ret;
   }
 
@@ -162,6 +188,14 @@ inline v8::Handle<v8::Value> AsyncWrap::MakeCallback(
     const v8::Handle<v8::Function> cb,
     int argc,
     v8::Handle<v8::Value>* argv) {
+  env()->loop_metrics()->OnCallback();
+
+  if (async_flags_ & HAS_ASYNC_STATS) {
+    uint64_t latency = created_ ? uv_hrtime() - created_ : 0;
+    env()->async_stats()->OnCallback(provider_index(), latency);
+    created_ = 0;
+  }
+
   if (env()->using_domains())
     return MakeDomainCallback(cb, argc, argv);
 
@@ -197,7 +231,7 @@ inline v8::Handle<v8::Value> AsyncWrap::MakeCallback(
 
   Environment::TickInfo* tick_info = env()->tick_info();
 
-  if (tick_info->in_tick()) {
+  if (tick_info->in_tick() || tick_info->in_batch()) {
     return ret;
   }
 
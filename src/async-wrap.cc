@@ -0,0 +1,97 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "async-wrap.h"
+#include "async-wrap-inl.h"
+#include "env.h"
+#include "env-inl.h"
+#include "node.h"
+#include "util.h"
+#include "util-inl.h"
+
+#include "v8.h"
+
+namespace node {
+
+using v8::Context;
+using v8::FunctionCallbackInfo;
+using v8::Handle;
+using v8::Integer;
+using v8::Local;
+using v8::Object;
+using v8::Value;
+using v8::kExternalFloat64Array;
+
+
+static void StartAsyncStats(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args.GetIsolate());
+  env->async_stats()->set_enabled(true);
+}
+
+
+static void StopAsyncStats(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args.GetIsolate());
+  env->async_stats()->set_enabled(false);
+}
+
+
+void AsyncWrap::Initialize(Handle<Object> target,
+                           Handle<Value> unused,
+                           Handle<Context> context) {
+  Environment* env = Environment::GetCurrent(context);
+  Environment::AsyncStats* async_stats = env->async_stats();
+
+  // Provider n occupies fields [n * kAsyncFieldsPerProvider,
+  // (n + 1) * kAsyncFieldsPerProvider) of the asyncStats array.
+  Local<Object> fields = Object::New(env->isolate());
+  fields->SetIndexedPropertiesToExternalArrayData(async_stats->fields(),
+                                                  kExternalFloat64Array,
+                                                  async_stats->fields_count());
+  target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "asyncStats"), fields);
+
+  Local<Object> providers = Object::New(env->isolate());
+#define V(PROVIDER)                                                           \
+  providers->Set(FIXED_ONE_BYTE_STRING(env->isolate(), #PROVIDER),            \
+                 Integer::New(env->isolate(),                                 \
+                              Environment::AsyncStats::kProvider ## PROVIDER));
+  NODE_ASYNC_PROVIDER_TYPES(V)
+#undef V
+  target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "providers"), providers);
+
+#define V(name, value)                                                        \
+  target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), name),                    \
+              Integer::New(env->isolate(), Environment::AsyncStats::value));
+  V("kAsyncCreated", kCreated)
+  V("kAsyncDestroyed", kDestroyed)
+  V("kAsyncCallbacks", kCallbacks)
+  V("kAsyncLatencyTotal", kLatencyTotal)
+  V("kAsyncLatency", kLatency)
+  V("kAsyncLatencyBuckets", kLatencyBuckets)
+  V("kAsyncFieldsPerProvider", kFieldsPerProvider)
+#undef V
+
+  NODE_SET_METHOD(target, "startAsyncStats", StartAsyncStats);
+  NODE_SET_METHOD(target, "stopAsyncStats", StopAsyncStats);
+}
+
+}  // namespace node
+
+NODE_MODULE_CONTEXT_AWARE_BUILTIN(async_wrap, node::AsyncWrap::Initialize)
@@ -32,29 +32,16 @@ class AsyncWrap : public BaseObject {
  public:
   enum AsyncFlags {
     NO_OPTIONS = 0,
-    HAS_ASYNC_LISTENER = 1
+    HAS_ASYNC_LISTENER = 1,
+    HAS_ASYNC_STATS = 2
   };
 
   enum ProviderType {
-    PROVIDER_NONE               = 1 << 0,
-    PROVIDER_CARES              = 1 << 1,
-    PROVIDER_CONNECTWRAP        = 1 << 2,
-    PROVIDER_CRYPTO             = 1 << 3,
-    PROVIDER_FSEVENTWRAP        = 1 << 4,
-    PROVIDER_GETADDRINFOREQWRAP = 1 << 5,
-    PROVIDER_PIPEWRAP           = 1 << 6,
-    PROVIDER_PROCESSWRAP        = 1 << 7,
-    PROVIDER_REQWRAP            = 1 << 8,
-    PROVIDER_SHUTDOWNWRAP       = 1 << 9,
-    PROVIDER_SIGNALWRAP         = 1 << 10,
-    PROVIDER_STATWATCHER        = 1 << 11,
-    PROVIDER_TCPWRAP            = 1 << 12,
-    PROVIDER_TIMERWRAP          = 1 << 13,
-    PROVIDER_TLSWRAP            = 1 << 14,
-    PROVIDER_TTYWRAP            = 1 << 15,
-    PROVIDER_UDPWRAP            = 1 << 16,
-    PROVIDER_ZLIB               = 1 << 17,
-    PROVIDER_GETNAMEINFOREQWRAP = 1 << 18
+#define V(PROVIDER)                                                           \
+    PROVIDER_ ## PROVIDER =                                                   \
+        1 << Environment::AsyncStats::kProvider ## PROVIDER,
+    NODE_ASYNC_PROVIDER_TYPES(V)
+#undef V
   };
 
   inline AsyncWrap(Environment* env,
@@ -67,6 +54,14 @@ class AsyncWrap : public BaseObject {
 
   inline uint32_t provider_type() const;
 
+  // Bit position of the provider type, the index into AsyncStats.
+  static inline int ProviderIndex(uint32_t provider_type);
+  inline int provider_index() const;
+
+  static void Initialize(v8::Handle<v8::Object> target,
+                         v8::Handle<v8::Value> unused,
+                         v8::Handle<v8::Context> context);
+
   // Only call these within a valid HandleScope.
   inline v8::Handle<v8::Value> MakeCallback(const v8::Handle<v8::Function> cb,
                                             int argc,
@@ -90,6 +85,9 @@ class AsyncWrap : public BaseObject {
 
   uint32_t async_flags_;
   uint32_t provider_type_;
+  // uv_hrtime() at construction, reset after the first callback.  Only
+  // tracked when the AsyncStats were enabled at construction time.
+  uint64_t created_;
 };
 
 }  // namespace node
@@ -98,10 +98,15 @@ inline Environment::IsolateData::IsolateData(v8::Isolate* isolate)
     PropertyName ## _(isolate, FIXED_ONE_BYTE_STRING(isolate, StringValue)),
     PER_ISOLATE_STRING_PROPERTIES(V)
 #undef V
-    ref_count_(0) {
+    ref_count_(0),
+    has_gc_callbacks_(false) {
   QUEUE_INIT(&gc_tracker_queue_);
 }
 
+inline Environment::GCStats* Environment::IsolateData::gc_stats() {
+  return &gc_stats_;
+}
+
 inline uv_loop_t* Environment::IsolateData::event_loop() const {
   return event_loop_;
 }
@@ -147,7 +152,9 @@ inline uint32_t Environment::DomainFlag::count() const {
   return fields_[kCount];
 }
 
-inline Environment::TickInfo::TickInfo() : in_tick_(false), last_threw_(false) {
+inline Environment::TickInfo::TickInfo() : in_batch_(false),
+                                            in_tick_(false),
+                                            last_threw_(false) {
   for (int i = 0; i < kFieldsCount; ++i)
     fields_[i] = 0;
 }
@@ -160,6 +167,10 @@ inline int Environment::TickInfo::fields_count() const {
   return kFieldsCount;
 }
 
+inline bool Environment::TickInfo::in_batch() const {
+  return in_batch_;
+}
+
 inline bool Environment::TickInfo::in_tick() const {
   return in_tick_;
 }
@@ -176,6 +187,10 @@ inline uint32_t Environment::TickInfo::length() const {
   return fields_[kLength];
 }
 
+inline void Environment::TickInfo::set_in_batch(bool value) {
+  in_batch_ = value;
+}
+
 inline void Environment::TickInfo::set_in_tick(bool value) {
   in_tick_ = value;
 }
@@ -188,6 +203,126 @@ inline void Environment::TickInfo::set_last_threw(bool value) {
   last_threw_ = value;
 }
 
+inline Environment::LoopMetrics::LoopMetrics() : mark_(0),
+                                                  initialized_(false),
+                                                  enabled_(false),
+                                                  in_poll_(false) {
+  for (int i = 0; i < kFieldsCount; ++i)
+    fields_[i] = 0;
+}
+
+inline double* Environment::LoopMetrics::fields() {
+  return fields_;
+}
+
+inline int Environment::LoopMetrics::fields_count() const {
+  return kFieldsCount;
+}
+
+inline bool Environment::LoopMetrics::enabled() const {
+  return enabled_;
+}
+
+// Adds the time since the last mark to |field|, in milliseconds.
+inline void Environment::LoopMetrics::Mark(int field) {
+  uint64_t now = uv_hrtime();
+  fields_[field] += (now - mark_) / 1e6;
+  mark_ = now;
+}
+
+inline void Environment::LoopMetrics::OnCallback() {
+  if (enabled_ == false)
+    return;
+  fields_[kEvents] += 1;
+  // The first callback of the poll phase ends the wait for I/O.
+  if (in_poll_) {
+    in_poll_ = false;
+    Mark(kIdleTime);
+  }
+}
+
+inline void Environment::LoopMetrics::OnTimer(uint64_t lateness) {
+  if (enabled_ == false)
+    return;
+  // |lateness| is in milliseconds, so bucket 0 is < 1 ms.
+  fields_[kTimerLateness + Log2Bucket(lateness, kTimerLatenessBuckets)] += 1;
+}
+
+inline Environment::AsyncStats::AsyncStats() : enabled_(false) {
+  for (int i = 0; i < kProviderCount * kFieldsPerProvider; ++i)
+    fields_[i] = 0;
+}
+
+inline double* Environment::AsyncStats::fields() {
+  return fields_;
+}
+
+inline int Environment::AsyncStats::fields_count() const {
+  return kProviderCount * kFieldsPerProvider;
+}
+
+inline bool Environment::AsyncStats::enabled() const {
+  return enabled_;
+}
+
+inline void Environment::AsyncStats::set_enabled(bool value) {
+  enabled_ = value;
+}
+
+inline void Environment::AsyncStats::OnCreate(int provider) {
+  fields_[provider * kFieldsPerProvider + kCreated] += 1;
+}
+
+inline void Environment::AsyncStats::OnDestroy(int provider) {
+  fields_[provider * kFieldsPerProvider + kDestroyed] += 1;
+}
+
+// |latency| is the time in nanoseconds between the creation of the wrap and
+// its first callback, or zero for subsequent callbacks.
+inline void Environment::AsyncStats::OnCallback(int provider,
+                                                uint64_t latency) {
+  double* fields = fields_ + provider * kFieldsPerProvider;
+  fields[kCallbacks] += 1;
+  if (latency == 0)
+    return;
+  fields[kLatencyTotal] += latency / 1e6;
+  fields[kLatency + Log2Bucket(latency / 1000, kLatencyBuckets)] += 1;
+}
+
+inline Environment::GCStats::GCStats() : enabled_(false) {
+  for (int i = 0; i < kTypeCount * kFieldsPerType; ++i)
+    fields_[i] = 0;
+}
+
+inline double* Environment::GCStats::fields() {
+  return fields_;
+}
+
+inline int Environment::GCStats::fields_count() const {
+  return kTypeCount * kFieldsPerType;
+}
+
+inline bool Environment::GCStats::enabled() const {
+  return enabled_;
+}
+
+inline void Environment::GCStats::set_enabled(bool value) {
+  enabled_ = value;
+}
+
+inline Environment::StatFields::StatFields() {
+  for (int i = 0; i < kFieldsCount; ++i)
+    fields_[i] = 0;
+}
+
+inline double* Environment::StatFields::fields() {
+  return fields_;
+}
+
+inline int Environment::StatFields::fields_count() const {
+  return kFieldsCount;
+}
+
 inline Environment* Environment::New(v8::Local<v8::Context> context) {
   Environment* env = new Environment(context);
   env->AssignToContext(context);
@@ -304,6 +439,24 @@ inline uv_check_t* Environment::idle_check_handle() {
   return &idle_check_handle_;
 }
 
+inline Environment* Environment::from_tick_batch_prepare_handle(
+    uv_prepare_t* handle) {
+  return ContainerOf(&Environment::tick_batch_prepare_handle_, handle);
+}
+
+inline uv_prepare_t* Environment::tick_batch_prepare_handle() {
+  return &tick_batch_prepare_handle_;
+}
+
+inline Environment* Environment::from_tick_batch_check_handle(
+    uv_check_t* handle) {
+  return ContainerOf(&Environment::tick_batch_check_handle_, handle);
+}
+
+inline uv_check_t* Environment::tick_batch_check_handle() {
+  return &tick_batch_check_handle_;
+}
+
 inline uv_loop_t* Environment::event_loop() const {
   return isolate_data()->event_loop();
 }
@@ -320,6 +473,22 @@ inline Environment::TickInfo* Environment::tick_info() {
   return &tick_info_;
 }
 
+inline Environment::LoopMetrics* Environment::loop_metrics() {
+  return &loop_metrics_;
+}
+
+inline Environment::AsyncStats* Environment::async_stats() {
+  return &async_stats_;
+}
+
+inline Environment::GCStats* Environment::gc_stats() {
+  return isolate_data()->gc_stats();
+}
+
+inline Environment::StatFields* Environment::stat_fields() {
+  return &stat_fields_;
+}
+
 inline bool Environment::using_smalloc_alloc_cb() const {
   return using_smalloc_alloc_cb_;
 }
@@ -197,6 +197,7 @@ namespace node {
   V(sni_context_string, "sni_context")                                        \
   V(speed_string, "speed")                                                    \
   V(stack_string, "stack")                                                    \
+  V(stat_values_string, "statValues")                                         \
   V(status_code_string, "statusCode")                                         \
   V(status_message_string, "statusMessage")                                   \
   V(status_string, "status")                                                  \
@@ -263,6 +264,29 @@ namespace node {
   V(tty_constructor_template, v8::FunctionTemplate)                           \
   V(udp_constructor_function, v8::Function)                                   \
 
+// The kinds of AsyncWrap, see AsyncWrap::ProviderType.  New ones go at the
+// end, their position is part of the asyncStats layout.
+#define NODE_ASYNC_PROVIDER_TYPES(V)                                          \
+  V(NONE)                                                                     \
+  V(CARES)                                                                    \
+  V(CONNECTWRAP)                                                              \
+  V(CRYPTO)                                                                   \
+  V(FSEVENTWRAP)                                                              \
+  V(GETADDRINFOREQWRAP)                                                       \
+  V(PIPEWRAP)                                                                 \
+  V(PROCESSWRAP)                                                              \
+  V(REQWRAP)                                                                  \
+  V(SHUTDOWNWRAP)                                                             \
+  V(SIGNALWRAP)                                                               \
+  V(STATWATCHER)                                                              \
+  V(TCPWRAP)                                                                  \
+  V(TIMERWRAP)                                                                \
+  V(TLSWRAP)                                                                  \
+  V(TTYWRAP)                                                                  \
+  V(UDPWRAP)                                                                  \
+  V(ZLIB)                                                                     \
+  V(GETNAMEINFOREQWRAP)                                                       \
+
 class Environment;
 
 // TODO(bnoordhuis) Rename struct, the ares_ prefix implies it's part
@@ -324,10 +348,12 @@ class Environment {
    public:
     inline uint32_t* fields();
     inline int fields_count() const;
+    inline bool in_batch() const;
     inline bool in_tick() const;
     inline bool last_threw() const;
     inline uint32_t index() const;
     inline uint32_t length() const;
+    inline void set_in_batch(bool value);
     inline void set_in_tick(bool value);
     inline void set_index(uint32_t value);
     inline void set_last_threw(bool value);
@@ -343,12 +369,165 @@ class Environment {
     };
 
     uint32_t fields_[kFieldsCount];
+    bool in_batch_;
     bool in_tick_;
     bool last_threw_;
 
     DISALLOW_COPY_AND_ASSIGN(TickInfo);
   };
 
+  // Where the event loop spends its time, see src/uv.cc.  Costs nothing
+  // but a flag check per callback until started.
+  class LoopMetrics {
+   public:
+    enum Fields {
+      kIterations,
+      kEvents,
+      kIdleTime,
+      kBusyTime,
+      kTimerLateness,
+      kTimerLatenessBuckets = 16,
+      kFieldsCount = kTimerLateness + kTimerLatenessBuckets
+    };
+
+    inline double* fields();
+    inline int fields_count() const;
+    inline bool enabled() const;
+    inline void OnCallback();
+    inline void OnTimer(uint64_t lateness);
+    void Start(uv_loop_t* loop);
+    void Stop();
+
+   private:
+    friend class Environment;  // So we can call the constructor.
+    inline LoopMetrics();
+    inline void Mark(int field);
+    static void OnPrepare(uv_prepare_t* handle);
+    static void OnCheck(uv_check_t* handle);
+
+    uv_prepare_t prepare_handle_;
+    uv_check_t check_handle_;
+    double fields_[kFieldsCount];
+    uint64_t mark_;
+    bool initialized_;
+    bool enabled_;
+    bool in_poll_;
+
+    DISALLOW_COPY_AND_ASSIGN(LoopMetrics);
+  };
+
+  // Per provider AsyncWrap statistics, see src/async-wrap.cc.  Providers
+  // are indexed by bit position, i.e. PROVIDER_CARES is provider 1.
+  class AsyncStats {
+   public:
+    enum Fields {
+      kCreated,
+      kDestroyed,
+      kCallbacks,
+      kLatencyTotal,
+      kLatency,
+      kLatencyBuckets = 24,
+      kFieldsPerProvider = kLatency + kLatencyBuckets
+    };
+
+    enum Providers {
+#define V(PROVIDER) kProvider ## PROVIDER,
+      NODE_ASYNC_PROVIDER_TYPES(V)
+#undef V
+      kProviderCount
+    };
+
+    inline double* fields();
+    inline int fields_count() const;
+    inline bool enabled() const;
+    inline void set_enabled(bool value);
+    inline void OnCreate(int provider);
+    inline void OnDestroy(int provider);
+    inline void OnCallback(int provider, uint64_t latency);
+
+   private:
+    friend class Environment;  // So we can call the constructor.
+    inline AsyncStats();
+
+    double fields_[kProviderCount * kFieldsPerProvider];
+    bool enabled_;
+
+    DISALLOW_COPY_AND_ASSIGN(AsyncStats);
+  };
+
+  // Pause times and reclaimed memory per GC type, see src/node_v8.cc.
+  // Garbage collection is per isolate so the stats are shared by all
+  // environments that live in the same isolate.
+  class GCStats {
+   public:
+    enum Types {
+      kScavenge,
+      kMarkSweepCompact,
+      kTypeCount
+    };
+
+    enum Fields {
+      kCount,
+      kPauseTotal,
+      kPauseMax,
+      kReclaimed,
+      kPause,
+      kPauseBuckets = 20,
+      kFieldsPerType = kPause + kPauseBuckets
+    };
+
+    inline GCStats();
+    inline double* fields();
+    inline int fields_count() const;
+    inline bool enabled() const;
+    inline void set_enabled(bool value);
+    void Record(v8::GCType type,
+                uint64_t pause,
+                size_t used_before,
+                size_t used_after);
+
+   private:
+    double fields_[kTypeCount * kFieldsPerType];
+    bool enabled_;
+
+    DISALLOW_COPY_AND_ASSIGN(GCStats);
+  };
+
+  // Scratch space that stat(), lstat() and fstat() write their results
+  // into, see src/node_file.cc.  lib/fs.js turns it into a fs.Stats object
+  // right away, before anything else can overwrite it.
+  class StatFields {
+   public:
+    enum Fields {
+      kDev,
+      kMode,
+      kNlink,
+      kUid,
+      kGid,
+      kRdev,
+      kBlkSize,
+      kIno,
+      kSize,
+      kBlocks,
+      kAtime,
+      kMtime,
+      kCtime,
+      kBirthtime,
+      kFieldsCount
+    };
+
+    inline double* fields();
+    inline int fields_count() const;
+
+   private:
+    friend class Environment;  // So we can call the constructor.
+    inline StatFields();
+
+    double fields_[kFieldsCount];
+
+    DISALLOW_COPY_AND_ASSIGN(StatFields);
+  };
+
   static inline Environment* GetCurrent(v8::Isolate* isolate);
   static inline Environment* GetCurrent(v8::Local<v8::Context> context);
   static inline Environment* GetCurrentChecked(v8::Isolate* isolate);
@@ -361,6 +540,8 @@ class Environment {
   // Defined in src/node_profiler.cc.
   void StartGarbageCollectionTracking(v8::Local<v8::Function> callback);
   void StopGarbageCollectionTracking();
+  void StartGarbageCollectionStats();
+  void StopGarbageCollectionStats();
 
   void AssignToContext(v8::Local<v8::Context> context);
 
@@ -380,9 +561,21 @@ class Environment {
   static inline Environment* from_idle_check_handle(uv_check_t* handle);
   inline uv_check_t* idle_check_handle();
 
+  static inline Environment* from_tick_batch_prepare_handle(
+      uv_prepare_t* handle);
+  inline uv_prepare_t* tick_batch_prepare_handle();
+
+  static inline Environment* from_tick_batch_check_handle(
+      uv_check_t* handle);
+  inline uv_check_t* tick_batch_check_handle();
+
   inline AsyncListener* async_listener();
   inline DomainFlag* domain_flag();
   inline TickInfo* tick_info();
+  inline LoopMetrics* loop_metrics();
+  inline AsyncStats* async_stats();
+  inline GCStats* gc_stats();
+  inline StatFields* stat_fields();
 
   static inline Environment* from_cares_timer_handle(uv_timer_t* handle);
   inline uv_timer_t* cares_timer_handle();
@@ -450,9 +643,14 @@ class Environment {
   uv_idle_t immediate_idle_handle_;
   uv_prepare_t idle_prepare_handle_;
   uv_check_t idle_check_handle_;
+  uv_prepare_t tick_batch_prepare_handle_;
+  uv_check_t tick_batch_check_handle_;
   AsyncListener async_listener_count_;
   DomainFlag domain_flag_;
   TickInfo tick_info_;
+  LoopMetrics loop_metrics_;
+  AsyncStats async_stats_;
+  StatFields stat_fields_;
   uv_timer_t cares_timer_handle_;
   ares_channel cares_channel_;
   ares_task_list cares_task_list_;
@@ -496,6 +694,10 @@ class Environment {
     // Defined in src/node_profiler.cc.
     void StartGarbageCollectionTracking(Environment* env);
     void StopGarbageCollectionTracking(Environment* env);
+    void StartGarbageCollectionStats();
+    void StopGarbageCollectionStats();
+
+    inline GCStats* gc_stats();
 
 #define V(PropertyName, StringValue)                                          \
     inline v8::Local<v8::String> PropertyName() const;
@@ -516,6 +718,7 @@ class Environment {
                                        v8::GCCallbackFlags flags);
     void BeforeGarbageCollection(v8::GCType type, v8::GCCallbackFlags flags);
     void AfterGarbageCollection(v8::GCType type, v8::GCCallbackFlags flags);
+    void UpdateGarbageCollectionCallbacks();
 
     uv_loop_t* const event_loop_;
     v8::Isolate* const isolate_;
@@ -529,6 +732,8 @@ class Environment {
     QUEUE gc_tracker_queue_;
     GCInfo gc_info_before_;
     GCInfo gc_info_after_;
+    GCStats gc_stats_;
+    bool has_gc_callbacks_;
 
     DISALLOW_COPY_AND_ASSIGN(IsolateData);
   };
@@ -30,8 +30,19 @@
 
 #include <stdlib.h>
 
+#if defined(__linux__)
+#include <dirent.h>
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace node {
 
+using v8::Array;
 using v8::Context;
 using v8::FunctionCallbackInfo;
 using v8::FunctionTemplate;
@@ -43,6 +54,10 @@ using v8::Object;
 using v8::String;
 using v8::Value;
 
+#if defined(__linux__)
+class InotifyTree;
+#endif
+
 class FSEventWrap: public HandleWrap {
  public:
   static void Initialize(Handle<Object> target,
@@ -59,17 +74,449 @@ class FSEventWrap: public HandleWrap {
   static void OnEvent(uv_fs_event_t* handle, const char* filename, int events,
     int status);
 
-  uv_fs_event_t handle_;
+#if defined(__linux__)
+  friend class InotifyTree;
+  int StartTree(const char* path, unsigned int latency);
+  static void OnTreeEvent(uv_poll_t* handle, int status, int events);
+
+  InotifyTree* tree_;
+#endif
+
+  // Recursive watches on Linux poll an inotify instance of their own.
+  union {
+    uv_fs_event_t event;
+    uv_poll_t poll;
+  } handle_;
   bool initialized_;
 };
 
 
+#if defined(__linux__)
+// inotify only watches single directories, so a recursive watch keeps a watch
+// on every directory below the root and adds and removes watches as
+// directories come and go.  Changes are coalesced per filename for |latency|
+// milliseconds, or for one read of the inotify fd when it's 0, and are then
+// delivered to JS in a single batch.
+class InotifyTree {
+ public:
+  InotifyTree(FSEventWrap* wrap, const char* path, unsigned int latency);
+  ~InotifyTree();
+
+  int Init(uv_loop_t* loop);
+  void Read();
+
+  inline int fd() const { return fd_; }
+
+ private:
+  static const uint32_t kMask = IN_ATTRIB | IN_CREATE | IN_MODIFY |
+                                IN_DELETE | IN_DELETE_SELF | IN_MOVE_SELF |
+                                IN_MOVED_FROM | IN_MOVED_TO;
+  static const unsigned int kBuckets = 1024;
+
+  struct Change {
+    Change* next;
+    Change* bucket_next;
+    uint32_t hash;
+    int events;
+    char name[1];
+  };
+
+  int AddTree(const char* dir, bool report);
+  void RemoveTree(const char* dir);
+  void SetDir(int wd, const char* dir);
+  int OnInotifyEvent(const struct inotify_event* e);
+  void Add(const char* name, int events);
+  void Flush();
+  void Error(int err);
+  static void OnTimer(uv_timer_t* handle);
+  static void OnTimerClose(uv_handle_t* handle);
+
+  FSEventWrap* const wrap_;
+  char* root_;
+  const char* basename_;
+  bool root_is_dir_;
+  int root_wd_;
+  int fd_;
+  unsigned int latency_;
+  uv_timer_t* timer_;
+
+  // Directory of every watch relative to root_, indexed by watch descriptor.
+  char** dirs_;
+  size_t dirs_size_;
+
+  // Pending changes, in the order they were first seen.
+  Change* buckets_[kBuckets];
+  Change* head_;
+  Change** tail_;
+  size_t count_;
+};
+
+
+static char* JoinPath(const char* dir, const char* name) {
+  size_t dir_len = strlen(dir);
+  size_t name_len = strlen(name);
+  char* path = static_cast<char*>(malloc(dir_len + name_len + 2));
+  if (path == NULL)
+    FatalError("node::JoinPath()", "Out Of Memory");
+  memcpy(path, dir, dir_len);
+  if (dir_len > 0 && name_len > 0)
+    path[dir_len++] = '/';
+  memcpy(path + dir_len, name, name_len + 1);
+  return path;
+}
+
+
+InotifyTree::InotifyTree(FSEventWrap* wrap,
+                         const char* path,
+                         unsigned int latency)
+    : wrap_(wrap),
+      root_(strdup(path)),
+      root_is_dir_(false),
+      root_wd_(-1),
+      fd_(-1),
+      latency_(latency),
+      timer_(NULL),
+      dirs_(NULL),
+      dirs_size_(0),
+      head_(NULL),
+      tail_(&head_),
+      count_(0) {
+  const char* slash = strrchr(root_, '/');
+  basename_ = slash != NULL ? slash + 1 : root_;
+  memset(buckets_, 0, sizeof(buckets_));
+}
+
+
+InotifyTree::~InotifyTree() {
+  while (head_ != NULL) {
+    Change* change = head_;
+    head_ = change->next;
+    free(change);
+  }
+  for (size_t i = 0; i < dirs_size_; i += 1)
+    free(dirs_[i]);
+  free(dirs_);
+  free(root_);
+  if (timer_ != NULL)
+    uv_close(reinterpret_cast<uv_handle_t*>(timer_), OnTimerClose);
+  if (fd_ != -1)
+    close(fd_);
+}
+
+
+int InotifyTree::Init(uv_loop_t* loop) {
+  fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd_ == -1)
+    return -errno;
+
+  struct stat s;
+  if (stat(root_, &s))
+    return -errno;
+  root_is_dir_ = S_ISDIR(s.st_mode);
+
+  if (root_is_dir_) {
+    int err = AddTree("", false);
+    if (err)
+      return err;
+  } else {
+    root_wd_ = inotify_add_watch(fd_, root_, kMask);
+    if (root_wd_ == -1)
+      return -errno;
+  }
+
+  timer_ = new uv_timer_t;
+  uv_timer_init(loop, timer_);
+  uv_unref(reinterpret_cast<uv_handle_t*>(timer_));
+  timer_->data = this;
+  return 0;
+}
+
+
+// Watches |dir| and every directory below it.  |report| adds everything that
+// is found as a change, for directories that were created or moved into the
+// tree after the fact and may have been filled before they were watched.
+// Directories below the root that can't be watched because they are gone or
+// unreadable are skipped, other errors like running out of watches are not.
+int InotifyTree::AddTree(const char* dir, bool report) {
+  char* path = JoinPath(root_, dir);
+  int wd = inotify_add_watch(fd_, path, kMask | IN_ONLYDIR | IN_DONT_FOLLOW);
+  if (wd == -1) {
+    int err = -errno;
+    free(path);
+    // Directories below the root can disappear, be unreadable or have been
+    // replaced by something else.
+    if (dir[0] != '\0' &&
+        (err == UV_ENOENT || err == UV_EACCES || err == UV_ENOTDIR)) {
+      return 0;
+    }
+    return err;
+  }
+  if (dir[0] == '\0')
+    root_wd_ = wd;
+  SetDir(wd, dir);
+
+  DIR* d = opendir(path);
+  free(path);
+  if (d == NULL)
+    return 0;
+
+  struct dirent* ent;
+  while ((ent = readdir(d)) != NULL) {
+    if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0)
+      continue;
+
+    char* child = JoinPath(dir, ent->d_name);
+    if (report)
+      Add(child, UV_RENAME);
+
+    bool is_dir = ent->d_type == DT_DIR;
+    if (ent->d_type == DT_UNKNOWN) {
+      char* child_path = JoinPath(root_, child);
+      struct stat s;
+      is_dir = lstat(child_path, &s) == 0 && S_ISDIR(s.st_mode);
+      free(child_path);
+    }
+    int err = is_dir ? AddTree(child, report) : 0;
+    free(child);
+    if (err) {
+      closedir(d);
+      return err;
+    }
+  }
+
+  closedir(d);
+  return 0;
+}
+
+
+// Drops the watches of |dir| and the directories below it, for directories
+// that were moved away.  inotify would keep reporting them under the old name.
+void InotifyTree::RemoveTree(const char* dir) {
+  size_t len = strlen(dir);
+  for (size_t wd = 0; wd < dirs_size_; wd += 1) {
+    if (dirs_[wd] == NULL || strncmp(dirs_[wd], dir, len) != 0)
+      continue;
+    if (dirs_[wd][len] != '\0' && dirs_[wd][len] != '/')
+      continue;
+    inotify_rm_watch(fd_, wd);
+    free(dirs_[wd]);
+    dirs_[wd] = NULL;
+  }
+}
+
+
+void InotifyTree::SetDir(int wd, const char* dir) {
+  if (static_cast<size_t>(wd) >= dirs_size_) {
+    size_t size = dirs_size_ * 2;
+    if (size <= static_cast<size_t>(wd))
+      size = wd + 1;
+    dirs_ = static_cast<char**>(realloc(dirs_, size * sizeof(*dirs_)));
+    if (dirs_ == NULL)
+      FatalError("node::InotifyTree::SetDir()", "Out Of Memory");
+    memset(dirs_ + dirs_size_, 0, (size - dirs_size_) * sizeof(*dirs_));
+    dirs_size_ = size;
+  }
+  free(dirs_[wd]);
+  dirs_[wd] = strdup(dir);
+}
+
+
+void InotifyTree::Read() {
+  char buf[4096]
+      __attribute__((aligned(__alignof__(struct inotify_event))));
+
+  for (;;) {
+    ssize_t size;
+    do {
+      size = read(fd_, buf, sizeof(buf));
+    } while (size == -1 && errno == EINTR);
+
+    if (size == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        break;
+      return Error(-errno);
+    }
+
+    for (const char* p = buf; p < buf + size; ) {
+      const struct inotify_event* e =
+          reinterpret_cast<const struct inotify_event*>(p);
+      int err = OnInotifyEvent(e);
+      if (err)
+        return Error(err);  // Can close the watcher.
+      p += sizeof(*e) + e->len;
+    }
+  }
+
+  if (count_ == 0)
+    return;
+  if (latency_ == 0)
+    return Flush();  // Can close the watcher.
+  if (!uv_is_active(reinterpret_cast<uv_handle_t*>(timer_)))
+    uv_timer_start(timer_, OnTimer, latency_, 0);
+}
+
+
+// Returns an error when a new directory couldn't be watched, e.g. because
+// the max_user_watches limit was reached.
+int InotifyTree::OnInotifyEvent(const struct inotify_event* e) {
+  // Events were dropped, tell JS that anything could have changed.
+  if (e->mask & IN_Q_OVERFLOW) {
+    Add("", UV_RENAME);
+    return 0;
+  }
+
+  if (e->wd < 0 || static_cast<size_t>(e->wd) >= dirs_size_ ||
+      dirs_[e->wd] == NULL) {
+    if (e->wd != root_wd_ || root_is_dir_)
+      return 0;  // Stale event for a watch that was removed.
+  }
+
+  if (e->mask & IN_IGNORED) {
+    if (static_cast<size_t>(e->wd) < dirs_size_) {
+      free(dirs_[e->wd]);
+      dirs_[e->wd] = NULL;
+    }
+    return 0;
+  }
+
+  int events = 0;
+  if (e->mask & (IN_ATTRIB | IN_MODIFY))
+    events |= UV_CHANGE;
+  if (e->mask & (kMask & ~(IN_ATTRIB | IN_MODIFY)))
+    events |= UV_RENAME;
+  if (events == 0)
+    return 0;
+
+  // Events on the watched directory itself, like libuv they are reported
+  // under the basename of the root.  Those of other directories show up in
+  // their parent too.
+  if (e->len == 0) {
+    if (e->wd == root_wd_)
+      Add(basename_, events);
+    return 0;
+  }
+
+  char* name = JoinPath(dirs_[e->wd], e->name);
+  Add(name, events);
+
+  int err = 0;
+  if (e->mask & IN_ISDIR) {
+    if (e->mask & IN_MOVED_FROM)
+      RemoveTree(name);
+    if (e->mask & (IN_CREATE | IN_MOVED_TO))
+      err = AddTree(name, true);
+  }
+
+  free(name);
+  return err;
+}
+
+
+// Merges |events| into the pending change for |name|.
+void InotifyTree::Add(const char* name, int events) {
+  uint32_t hash = 2166136261u;  // FNV-1a
+  for (const char* p = name; *p != '\0'; p += 1)
+    hash = (hash ^ static_cast<unsigned char>(*p)) * 16777619u;
+
+  Change** bucket = &buckets_[hash % kBuckets];
+  for (Change* change = *bucket; change != NULL; change = change->bucket_next) {
+    if (change->hash == hash && strcmp(change->name, name) == 0) {
+      change->events |= events;
+      return;
+    }
+  }
+
+  size_t len = strlen(name);
+  Change* change = static_cast<Change*>(malloc(sizeof(*change) + len));
+  if (change == NULL)
+    FatalError("node::InotifyTree::Add()", "Out Of Memory");
+  change->next = NULL;
+  change->bucket_next = *bucket;
+  change->hash = hash;
+  change->events = events;
+  memcpy(change->name, name, len + 1);
+  *bucket = change;
+  *tail_ = change;
+  tail_ = &change->next;
+  count_ += 1;
+}
+
+
+// Calls onchange(0, events, filenames) with the pending changes.  A change
+// with a null filename means that events were lost.
+void InotifyTree::Flush() {
+  Environment* env = wrap_->env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+
+  Local<Array> events = Array::New(env->isolate(), count_);
+  Local<Array> filenames = Array::New(env->isolate(), count_);
+
+  Change* change = head_;
+  for (uint32_t i = 0; change != NULL; i += 1) {
+    Change* next = change->next;
+    // Like OnEvent, a rename implies a change.
+    if (change->events & UV_RENAME)
+      events->Set(i, env->rename_string());
+    else
+      events->Set(i, env->change_string());
+    if (change->name[0] == '\0')
+      filenames->Set(i, Null(env->isolate()));
+    else
+      filenames->Set(i, String::NewFromUtf8(env->isolate(), change->name));
+    free(change);
+    change = next;
+  }
+
+  memset(buckets_, 0, sizeof(buckets_));
+  head_ = NULL;
+  tail_ = &head_;
+  count_ = 0;
+  uv_timer_stop(timer_);
+
+  Local<Value> argv[] = {
+    Integer::New(env->isolate(), 0),
+    events,
+    filenames
+  };
+  wrap_->MakeCallback(env->onchange_string(), ARRAY_SIZE(argv), argv);
+}
+
+
+void InotifyTree::Error(int err) {
+  Environment* env = wrap_->env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+
+  Local<Value> argv[] = {
+    Integer::New(env->isolate(), err),
+    String::Empty(env->isolate()),
+    Null(env->isolate())
+  };
+  wrap_->MakeCallback(env->onchange_string(), ARRAY_SIZE(argv), argv);
+}
+
+
+void InotifyTree::OnTimer(uv_timer_t* handle) {
+  static_cast<InotifyTree*>(handle->data)->Flush();
+}
+
+
+void InotifyTree::OnTimerClose(uv_handle_t* handle) {
+  delete reinterpret_cast<uv_timer_t*>(handle);
+}
+#endif  // defined(__linux__)
+
+
 FSEventWrap::FSEventWrap(Environment* env, Handle<Object> object)
     : HandleWrap(env,
                  object,
                  reinterpret_cast<uv_handle_t*>(&handle_),
                  AsyncWrap::PROVIDER_FSEVENTWRAP) {
   initialized_ = false;
+#if defined(__linux__)
+  tree_ = NULL;
+#endif
 }
 
 
@@ -118,26 +565,60 @@ void FSEventWrap::Start(const FunctionCallbackInfo<Value>& args) {
   if (args[2]->IsTrue())
     flags |= UV_FS_EVENT_RECURSIVE;
 
-  int err = uv_fs_event_init(wrap->env()->event_loop(), &wrap->handle_);
-  if (err == 0) {
-    wrap->initialized_ = true;
-
-    err = uv_fs_event_start(&wrap->handle_, OnEvent, *path, flags);
-
+  int err;
+#if defined(__linux__)
+  // libuv ignores UV_FS_EVENT_RECURSIVE on Linux.
+  if (flags & UV_FS_EVENT_RECURSIVE) {
+    err = wrap->StartTree(*path, args[3]->Uint32Value());
+  } else  // NOLINT(readability/braces)
+#endif
+  {
+    err = uv_fs_event_init(wrap->env()->event_loop(), &wrap->handle_.event);
     if (err == 0) {
-      // Check for persistent argument
-      if (!args[1]->IsTrue()) {
-        uv_unref(reinterpret_cast<uv_handle_t*>(&wrap->handle_));
-      }
-    } else {
-      FSEventWrap::Close(args);
+      wrap->initialized_ = true;
+      err = uv_fs_event_start(&wrap->handle_.event, OnEvent, *path, flags);
     }
   }
 
+  if (err == 0) {
+    // Check for persistent argument
+    if (!args[1]->IsTrue()) {
+      uv_unref(reinterpret_cast<uv_handle_t*>(&wrap->handle_));
+    }
+  } else if (wrap->initialized_) {
+    FSEventWrap::Close(args);
+  }
+
   args.GetReturnValue().Set(err);
 }
 
 
+#if defined(__linux__)
+int FSEventWrap::StartTree(const char* path, unsigned int latency) {
+  InotifyTree* tree = new InotifyTree(this, path, latency);
+  int err = tree->Init(env()->event_loop());
+  if (err == 0)
+    err = uv_poll_init(env()->event_loop(), &handle_.poll, tree->fd());
+  if (err) {
+    delete tree;
+    return err;
+  }
+
+  initialized_ = true;
+  tree_ = tree;
+  return uv_poll_start(&handle_.poll, UV_READABLE, OnTreeEvent);
+}
+
+
+void FSEventWrap::OnTreeEvent(uv_poll_t* handle, int status, int events) {
+  FSEventWrap* wrap = static_cast<FSEventWrap*>(handle->data);
+  assert(wrap->persistent().IsEmpty() == false);
+  assert(wrap->tree_ != NULL);
+  wrap->tree_->Read();
+}
+#endif
+
+
 void FSEventWrap::OnEvent(uv_fs_event_t* handle, const char* filename,
     int events, int status) {
   FSEventWrap* wrap = static_cast<FSEventWrap*>(handle->data);
@@ -196,6 +677,12 @@ void FSEventWrap::Close(const FunctionCallbackInfo<Value>& args) {
   wrap->initialized_ = false;
 
   HandleWrap::Close(args);
+
+#if defined(__linux__)
+  // After the poll handle has stopped watching the inotify fd.
+  delete wrap->tree_;
+  wrap->tree_ = NULL;
+#endif
 }
 
 }  // namespace node
@@ -126,6 +126,7 @@ static bool print_eval = false;
 static bool force_repl = false;
 static bool trace_deprecation = false;
 static bool throw_deprecation = false;
+static bool batch_ticks = false;
 static const char* eval_string = NULL;
 static bool use_debug_agent = false;
 static bool debug_wait_connect = false;
@@ -188,8 +189,71 @@ void ArrayBufferAllocator::Free(void* data, size_t length) {
 }
 
 
+// With --batch-ticks, MakeCallback() doesn't drain the nextTick queue for
+// callbacks that run in the poll phase of the event loop, i.e. I/O
+// completions.  The queue is drained once after the poll phase instead.
+// That saves a JS round trip per callback at the cost of letting I/O
+// callbacks from the same loop iteration run before each other's ticks.
+static void StartTickBatch(uv_prepare_t* handle) {
+  Environment* env = Environment::from_tick_batch_prepare_handle(handle);
+  env->tick_info()->set_in_batch(true);
+}
+
+
+static void EndTickBatch(Environment* env) {
+  Environment::TickInfo* tick_info = env->tick_info();
+  tick_info->set_in_batch(false);
+
+  if (tick_info->in_tick()) {
+    return;
+  }
+
+  if (tick_info->length() == 0) {
+    tick_info->set_index(0);
+    return;
+  }
+
+  HandleScope scope(env->isolate());
+  Context::Scope context_scope(env->context());
+  TryCatch try_catch;
+  try_catch.SetVerbose(true);
+
+  tick_info->set_in_tick(true);
+  env->tick_callback_function()->Call(env->process_object(), 0, NULL);
+  tick_info->set_in_tick(false);
+
+  if (try_catch.HasCaught()) {
+    tick_info->set_last_threw(true);
+  }
+}
+
+
+static void CheckImmediate(uv_check_t* handle);
+
+
+static void EndTickBatch(uv_check_t* handle) {
+  Environment* env = Environment::from_tick_batch_check_handle(handle);
+  uv_check_t* immediate_check_handle = env->immediate_check_handle();
+  const uv_handle_t* immediate_handle =
+      reinterpret_cast<const uv_handle_t*>(immediate_check_handle);
+  bool had_immediates = uv_is_active(immediate_handle);
+
+  EndTickBatch(env);
+
+  // A check watcher that is started by another check watcher doesn't run
+  // until the next loop iteration.  Without batching, the ticks would have
+  // queued their immediates before the check phase, so run them now.
+  if (had_immediates == false && uv_is_active(immediate_handle))
+    CheckImmediate(immediate_check_handle);
+}
+
+
 static void CheckImmediate(uv_check_t* handle) {
   Environment* env = Environment::from_immediate_check_handle(handle);
+  // Check watchers run in no particular order, make sure that the ticks
+  // from the poll phase run before the immediates.
+  if (env->tick_info()->in_batch())
+    EndTickBatch(env);
   HandleScope scope(env->isolate());
   Context::Scope context_scope(env->context());
   MakeCallback(env, env->process_object(), env->immediate_callback_string());
@@ -1067,7 +1131,7 @@ Handle<Value> MakeDomainCallback(Environment* env,
     return ret;
   }
 
-  if (tick_info->in_tick()) {
+  if (tick_info->in_tick() || tick_info->in_batch()) {
     return ret;
   }
 
@@ -1096,6 +1160,8 @@ Handle<Value> MakeCallback(Environment* env,
                            const Handle<Function> callback,
                            int argc,
                            Handle<Value> argv[]) {
+  env->loop_metrics()->OnCallback();
+
   if (env->using_domains())
     return MakeDomainCallback(env, recv, callback, argc, argv);
 
@@ -1131,7 +1197,7 @@ Handle<Value> MakeCallback(Environment* env,
 
   Environment::TickInfo* tick_info = env->tick_info();
 
-  if (tick_info->in_tick()) {
+  if (tick_info->in_tick() || tick_info->in_batch()) {
     return ret;
   }
 
@@ -2941,6 +3007,8 @@ static void PrintHelp() {
          "  --throw-deprecation  throw an exception anytime a deprecated "
          "function is used\n"
          "  --trace-deprecation  show stack traces on deprecations\n"
+         "  --batch-ticks        process nextTick callbacks once per batch\n"
+         "                       of I/O callbacks\n"
          "  --v8-options         print v8 command line options\n"
          "  --max-stack-size=val set max v8 stack size (bytes)\n"
          "\n"
@@ -2954,6 +3022,8 @@ static void PrintHelp() {
          "NODE_MODULE_CONTEXTS   Set to 1 to load modules in their own\n"
          "                       global contexts.\n"
          "NODE_DISABLE_COLORS    Set to 1 to disable colors in the REPL\n"
+         "NODE_CODE_CACHE_DIR    Directory to cache compiled module data\n"
+         "                       in between runs.\n"
          "\n"
          "Documentation can be found at http://nodejs.org/\n");
 }
@@ -3041,6 +3111,8 @@ static void ParseArgs(int* argc,
       trace_deprecation = true;
     } else if (strcmp(arg, "--throw-deprecation") == 0) {
       throw_deprecation = true;
+    } else if (strcmp(arg, "--batch-ticks") == 0) {
+      batch_ticks = true;
     } else if (strcmp(arg, "--v8-options") == 0) {
       new_v8_argv[new_v8_argc] = "--help";
       new_v8_argc += 1;
@@ -3565,6 +3637,16 @@ Environment* CreateEnvironment(Isolate* isolate,
     StartProfilerIdleNotifier(env);
   }
 
+  uv_prepare_init(env->event_loop(), env->tick_batch_prepare_handle());
+  uv_check_init(env->event_loop(), env->tick_batch_check_handle());
+  uv_unref(reinterpret_cast<uv_handle_t*>(env->tick_batch_prepare_handle()));
+  uv_unref(reinterpret_cast<uv_handle_t*>(env->tick_batch_check_handle()));
+
+  if (batch_ticks) {
+    uv_prepare_start(env->tick_batch_prepare_handle(), StartTickBatch);
+    uv_check_start(env->tick_batch_check_handle(), EndTickBatch);
+  }
+
   Local<FunctionTemplate> process_template = FunctionTemplate::New(isolate);
   process_template->SetClassName(FIXED_ONE_BYTE_STRING(isolate, "process"));
 
@@ -688,8 +688,11 @@
       var fd = parseInt(process.env.NODE_CHANNEL_FD, 10);
       assert(fd >= 0);
 
+      var framing = process.env.NODE_CHANNEL_FRAMING;
+
       // Make sure it's not accidentally inherited by child processes.
       delete process.env.NODE_CHANNEL_FD;
+      delete process.env.NODE_CHANNEL_FRAMING;
 
       var cp = NativeModule.require('child_process');
 
@@ -698,7 +701,7 @@
       // FIXME is this really necessary?
       process.binding('tcp_wrap');
 
-      cp._forkChild(fd);
+      cp._forkChild(fd, framing);
       assert(process.send);
     }
   };
@@ -61,6 +61,7 @@
 namespace node {
 namespace Buffer {
 
+using v8::Array;
 using v8::ArrayBuffer;
 using v8::Context;
 using v8::EscapableHandleScope;
@@ -338,6 +339,68 @@ void Copy(const FunctionCallbackInfo<Value> &args) {
 }
 
 
+// bytesCopied = buffer.gather(list[, targetStart]);
+// Copies the Buffers in |list| back to back into this buffer, stops when
+// it's full.
+void Gather(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args.GetIsolate());
+  HandleScope scope(env->isolate());
+
+  if (!args[0]->IsArray())
+    return env->ThrowTypeError("first arg should be an Array");
+
+  ARGS_THIS(args.This())
+  Local<Array> list = args[0].As<Array>();
+  size_t target_start;
+
+  CHECK_NOT_OOB(ParseArrayIndex(args[1], 0, &target_start));
+  CHECK_NOT_OOB(target_start <= obj_length);
+
+  size_t pos = target_start;
+  for (uint32_t i = 0, n = list->Length(); i < n && pos < obj_length; i++) {
+    Local<Value> source = list->Get(i);
+    if (!HasInstance(source))
+      return env->ThrowTypeError("list should only contain Buffers");
+    size_t to_copy = MIN(Length(source), obj_length - pos);
+    memmove(obj_data + pos, node::Buffer::Data(source), to_copy);
+    pos += to_copy;
+  }
+
+  args.GetReturnValue().Set(static_cast<uint32_t>(pos - target_start));
+}
+
+
+// bytesCopied = buffer.scatter(list[, sourceStart]);
+// The inverse of gather(), fills the Buffers in |list| one after the other
+// with consecutive bytes from this buffer.
+void Scatter(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args.GetIsolate());
+  HandleScope scope(env->isolate());
+
+  if (!args[0]->IsArray())
+    return env->ThrowTypeError("first arg should be an Array");
+
+  ARGS_THIS(args.This())
+  Local<Array> list = args[0].As<Array>();
+  size_t source_start;
+
+  CHECK_NOT_OOB(ParseArrayIndex(args[1], 0, &source_start));
+  CHECK_NOT_OOB(source_start <= obj_length);
+
+  size_t pos = source_start;
+  for (uint32_t i = 0, n = list->Length(); i < n && pos < obj_length; i++) {
+    Local<Value> target = list->Get(i);
+    if (!HasInstance(target))
+      return env->ThrowTypeError("list should only contain Buffers");
+    size_t to_copy = MIN(Length(target), obj_length - pos);
+    memmove(node::Buffer::Data(target), obj_data + pos, to_copy);
+    pos += to_copy;
+  }
+
+  args.GetReturnValue().Set(static_cast<uint32_t>(pos - source_start));
+}
+
+
 // buffer.fill(value[, start][, end]);
 void Fill(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args.GetIsolate());
@@ -620,6 +683,117 @@ void Compare(const FunctionCallbackInfo<Value> &args) {
 }
 
 
+// Returns the offset of the first occurrence of |needle| in |haystack| at or
+// after |offset|, or -1.  memchr() is usually vectorized by libc so it's
+// used to find candidates for short needles.  Longer needles are searched
+// for with Boyer-Moore-Horspool.
+static int32_t SearchBytes(const char* haystack,
+                           size_t haystack_length,
+                           const char* needle,
+                           size_t needle_length,
+                           size_t offset) {
+  if (needle_length > haystack_length ||
+      offset > haystack_length - needle_length) {
+    return -1;
+  }
+
+  if (needle_length == 0)
+    return offset;
+
+  const unsigned char* h = reinterpret_cast<const unsigned char*>(haystack);
+  const unsigned char* n = reinterpret_cast<const unsigned char*>(needle);
+  const size_t last = needle_length - 1;
+
+  if (needle_length < 8) {
+    const unsigned char* p = h + offset;
+    const unsigned char* end = h + haystack_length - last;
+    while (p < end) {
+      p = static_cast<const unsigned char*>(memchr(p, n[0], end - p));
+      if (p == NULL)
+        return -1;
+      if (memcmp(p + 1, n + 1, last) == 0)
+        return p - h;
+      p += 1;
+    }
+    return -1;
+  }
+
+  size_t skip[256];
+  for (size_t i = 0; i < 256; i += 1)
+    skip[i] = needle_length;
+  for (size_t i = 0; i < last; i += 1)
+    skip[n[i]] = last - i;
+
+  for (size_t i = offset; i <= haystack_length - needle_length;) {
+    const unsigned char c = h[i + last];
+    if (c == n[last] && memcmp(h + i, n, last) == 0)
+      return i;
+    i += skip[c];
+  }
+
+  return -1;
+}
+
+
+// Negative offsets count from the end of the buffer.
+static size_t ParseSearchOffset(Handle<Value> arg, size_t length) {
+  int64_t offset = arg->IntegerValue();
+  if (offset < 0) {
+    offset += length;
+    if (offset < 0)
+      offset = 0;
+  }
+  return static_cast<size_t>(offset);
+}
+
+
+// buffer.indexOf(string[, byteOffset]), the string is searched for as UTF-8.
+void IndexOfString(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args.GetIsolate());
+  HandleScope scope(env->isolate());
+
+  if (!args[1]->IsString())
+    return env->ThrowTypeError("Argument must be a string");
+
+  ARGS_THIS(args[0].As<Object>())
+  node::Utf8Value needle(args[1]);
+  size_t offset = ParseSearchOffset(args[2], obj_length);
+
+  args.GetReturnValue().Set(
+      SearchBytes(obj_data, obj_length, *needle, needle.length(), offset));
+}
+
+
+// buffer.indexOf(buffer[, byteOffset])
+void IndexOfBuffer(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args.GetIsolate());
+  HandleScope scope(env->isolate());
+
+  if (!HasInstance(args[1]))
+    return env->ThrowTypeError("Argument must be a Buffer");
+
+  ARGS_THIS(args[0].As<Object>())
+  Local<Object> needle = args[1].As<Object>();
+  const char* needle_data = node::Buffer::Data(needle);
+  size_t needle_length = Length(needle);
+  size_t offset = ParseSearchOffset(args[2], obj_length);
+
+  args.GetReturnValue().Set(
+      SearchBytes(obj_data, obj_length, needle_data, needle_length, offset));
+}
+
+
+// buffer.indexOf(byte[, byteOffset])
+void IndexOfNumber(const FunctionCallbackInfo<Value>& args) {
+  ARGS_THIS(args[0].As<Object>())
+  char needle = static_cast<char>(args[1]->Uint32Value() & 255);
+  size_t offset = ParseSearchOffset(args[2], obj_length);
+
+  args.GetReturnValue().Set(
+      SearchBytes(obj_data, obj_length, &needle, 1, offset));
+}
+
+
 // pass Buffer object to load prototype methods
 void SetupBufferJS(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args.GetIsolate());
@@ -661,6 +835,8 @@ void SetupBufferJS(const FunctionCallbackInfo<Value>& args) {
 
   NODE_SET_METHOD(proto, "copy", Copy);
   NODE_SET_METHOD(proto, "fill", Fill);
+  NODE_SET_METHOD(proto, "gather", Gather);
+  NODE_SET_METHOD(proto, "scatter", Scatter);
 
   // for backwards compatibility
   proto->Set(env->offset_string(),
@@ -677,6 +853,10 @@ void SetupBufferJS(const FunctionCallbackInfo<Value>& args) {
   internal->Set(env->compare_string(),
                 FunctionTemplate::New(
                     env->isolate(), Compare)->GetFunction());
+
+  NODE_SET_METHOD(internal, "indexOfBuffer", IndexOfBuffer);
+  NODE_SET_METHOD(internal, "indexOfNumber", IndexOfNumber);
+  NODE_SET_METHOD(internal, "indexOfString", IndexOfString);
 }
 
 
@@ -20,6 +20,7 @@
 // USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include "node.h"
+#include "node_buffer.h"
 #include "node_internals.h"
 #include "node_watchdog.h"
 #include "base-object.h"
@@ -470,15 +471,47 @@ class ContextifyScript : public BaseObject {
     Local<String> code = args[0]->ToString();
     Local<String> filename = GetFilenameArg(args, 1);
     bool display_errors = GetDisplayErrorsArg(args, 1);
+    Local<Object> cached_data_buf = GetCachedDataArg(args, 1);
+    bool produce_cached_data = GetProduceCachedDataArg(args, 1);
     if (try_catch.HasCaught()) {
       try_catch.ReThrow();
       return;
     }
 
+    ScriptCompiler::CachedData* cached_data = NULL;
+    if (!cached_data_buf.IsEmpty()) {
+      const char* data = Buffer::Data(cached_data_buf);
+      cached_data = new ScriptCompiler::CachedData(
+          reinterpret_cast<const uint8_t*>(data),
+          Buffer::Length(cached_data_buf));
+    }
+
+    // V8 refuses to produce cached data when it is given some to consume.
+    ScriptCompiler::CompileOptions compile_options =
+        ScriptCompiler::kNoCompileOptions;
+    if (produce_cached_data && cached_data == NULL)
+      compile_options = ScriptCompiler::kProduceDataToCache;
+
     ScriptOrigin origin(filename);
-    ScriptCompiler::Source source(code, origin);
+    ScriptCompiler::Source source(code, origin, cached_data);
     Local<UnboundScript> v8_script =
-        ScriptCompiler::CompileUnbound(env->isolate(), &source);
+        ScriptCompiler::CompileUnbound(env->isolate(), &source,
+                                       compile_options);
+
+    if (cached_data != NULL) {
+      // Stale or corrupt cached data makes the compile fail.  Try again
+      // without it; if that works, the cached data was the problem.
+      bool rejected = v8_script.IsEmpty();
+      if (rejected) {
+        try_catch.Reset();
+        ScriptCompiler::Source retry(code, origin);
+        v8_script = ScriptCompiler::CompileUnbound(env->isolate(), &retry);
+        rejected = !v8_script.IsEmpty();
+      }
+      args.This()->Set(FIXED_ONE_BYTE_STRING(env->isolate(),
+                                             "cachedDataRejected"),
+                       Boolean::New(env->isolate(), rejected));
+    }
 
     if (v8_script.IsEmpty()) {
       if (display_errors) {
@@ -488,6 +521,20 @@ class ContextifyScript : public BaseObject {
       return;
     }
     contextify_script->script_.Reset(env->isolate(), v8_script);
+
+    if (compile_options == ScriptCompiler::kProduceDataToCache) {
+      const ScriptCompiler::CachedData* produced = source.GetCachedData();
+      // Not all scripts produce cached data, e.g. ones that V8 found in
+      // its own compilation cache.
+      if (produced != NULL) {
+        Local<Object> buf = Buffer::New(
+            env,
+            reinterpret_cast<const char*>(produced->data),
+            produced->length);
+        args.This()->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "cachedData"),
+                         buf);
+      }
+    }
   }
 
 
@@ -604,6 +651,44 @@ class ContextifyScript : public BaseObject {
   }
 
 
+  static Local<Object> GetCachedDataArg(
+      const FunctionCallbackInfo<Value>& args,
+      const int i) {
+    if (!args[i]->IsObject()) {
+      return Local<Object>();
+    }
+
+    Local<String> key = FIXED_ONE_BYTE_STRING(args.GetIsolate(),
+                                              "cachedData");
+    Local<Value> value = args[i].As<Object>()->Get(key);
+    if (value->IsUndefined()) {
+      return Local<Object>();
+    }
+
+    if (!Buffer::HasInstance(value)) {
+      Environment::ThrowTypeError(args.GetIsolate(),
+                                  "options.cachedData must be a Buffer");
+      return Local<Object>();
+    }
+    return value.As<Object>();
+  }
+
+
+  static bool GetProduceCachedDataArg(
+      const FunctionCallbackInfo<Value>& args,
+      const int i) {
+    if (!args[i]->IsObject()) {
+      return false;
+    }
+
+    Local<String> key = FIXED_ONE_BYTE_STRING(args.GetIsolate(),
+                                              "produceCachedData");
+    Local<Value> value = args[i].As<Object>()->Get(key);
+
+    return value->BooleanValue();
+  }
+
+
   static Local<String> GetFilenameArg(const FunctionCallbackInfo<Value>& args,
                                       const int i) {
     Local<String> defaultFilename =
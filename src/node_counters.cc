@@ -127,9 +127,11 @@ void InitPerfCounters(Environment* env, Handle<Object> target) {
     target->Set(key, val);
   }
 
-  // Only Windows performance counters supported
-  // To enable other OS, use conditional compilation here
+#ifdef _WIN32
   InitPerfCountersWin32();
+#else
+  InitPerfCountersLinux();
+#endif
 
   // init times for GC percent calculation and hook callbacks
   counter_gc_start_time = NODE_COUNT_GET_GC_RAWTIME();
@@ -141,9 +143,11 @@ void InitPerfCounters(Environment* env, Handle<Object> target) {
 
 
 void TermPerfCounters(Handle<Object> target) {
-  // Only Windows performance counters supported
-  // To enable other OS, use conditional compilation here
+#ifdef _WIN32
   TermPerfCountersWin32();
+#else
+  TermPerfCountersLinux();
+#endif
 }
 
 }  // namespace node
@@ -25,8 +25,12 @@
 #include "node.h"
 
 #ifdef HAVE_PERFCTR
+#ifdef _WIN32
 #include "node_win32_perfctr_provider.h"
 #else
+#include "node_linux_perfctr_provider.h"
+#endif
+#else
 #define NODE_COUNTER_ENABLED() (false)
 #define NODE_COUNT_HTTP_SERVER_REQUEST()
 #define NODE_COUNT_HTTP_SERVER_RESPONSE()
@@ -43,9 +43,20 @@
 # include <io.h>
 #endif
 
+#ifndef _WIN32
+# include <dirent.h>
+# include <unistd.h>
+#endif
+
+#if defined(__linux__)
+# include <sys/sendfile.h>
+# include <sys/syscall.h>
+#endif
+
 namespace node {
 
 using v8::Array;
+using v8::Boolean;
 using v8::Context;
 using v8::EscapableHandleScope;
 using v8::Function;
@@ -59,8 +70,11 @@ using v8::Number;
 using v8::Object;
 using v8::String;
 using v8::Value;
+using v8::kExternalFloat64Array;
+using v8::kExternalInt32Array;
 
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
 
 #define TYPE_ERROR(msg) env->ThrowTypeError(msg)
 
@@ -114,6 +128,10 @@ static inline bool IsInt64(double x) {
 }
 
 
+static double* GetStatsArray(Local<Value> value);
+static void FillStatsArray(double* fields, const uv_stat_t* s);
+
+
 static void After(uv_fs_t *req) {
   FSReqWrap* req_wrap = static_cast<FSReqWrap*>(req->data);
   assert(&req_wrap->req_ == req);
@@ -191,8 +209,18 @@ static void After(uv_fs_t *req) {
       case UV_FS_STAT:
       case UV_FS_LSTAT:
       case UV_FS_FSTAT:
-        argv[1] = BuildStatsObject(env,
-                                   static_cast<const uv_stat_t*>(req->ptr));
+        {
+          const uv_stat_t* s = static_cast<const uv_stat_t*>(req->ptr);
+          Local<Value> target =
+              req_wrap->object()->Get(env->stat_values_string());
+          double* fields = GetStatsArray(target);
+          if (fields != NULL) {
+            FillStatsArray(fields, s);
+            argc = 1;
+          } else {
+            argv[1] = BuildStatsObject(env, s);
+          }
+        }
         break;
 
       case UV_FS_READLINK:
@@ -421,6 +449,58 @@ Local<Value> BuildStatsObject(Environment* env, const uv_stat_t* s) {
   return handle_scope.Escape(stats);
 }
 
+// Returns the backing store of |value| when it is a Float64Array that is
+// big enough to hold a stat result, NULL otherwise.
+static double* GetStatsArray(Local<Value> value) {
+  if (!value->IsObject())
+    return NULL;
+  Local<Object> object = value.As<Object>();
+  if (!object->HasIndexedPropertiesInExternalArrayData())
+    return NULL;
+  if (object->GetIndexedPropertiesExternalArrayDataType() !=
+      kExternalFloat64Array)
+    return NULL;
+  if (object->GetIndexedPropertiesExternalArrayDataLength() <
+      Environment::StatFields::kFieldsCount)
+    return NULL;
+  return static_cast<double*>(
+      object->GetIndexedPropertiesExternalArrayData());
+}
+
+// The allocation-free sibling of BuildStatsObject(), fields are laid out
+// as described by Environment::StatFields.
+static void FillStatsArray(double* fields, const uv_stat_t* s) {
+  typedef Environment::StatFields StatFields;
+
+  fields[StatFields::kDev] = static_cast<double>(s->st_dev);
+  fields[StatFields::kMode] = static_cast<double>(s->st_mode);
+  fields[StatFields::kNlink] = static_cast<double>(s->st_nlink);
+  fields[StatFields::kUid] = static_cast<double>(s->st_uid);
+  fields[StatFields::kGid] = static_cast<double>(s->st_gid);
+  fields[StatFields::kRdev] = static_cast<double>(s->st_rdev);
+  fields[StatFields::kIno] = static_cast<double>(s->st_ino);
+  fields[StatFields::kSize] = static_cast<double>(s->st_size);
+# if defined(__POSIX__)
+  fields[StatFields::kBlkSize] = static_cast<double>(s->st_blksize);
+  fields[StatFields::kBlocks] = static_cast<double>(s->st_blocks);
+# else
+  // lib/fs.js turns these back into undefined.
+  fields[StatFields::kBlkSize] = -1;
+  fields[StatFields::kBlocks] = -1;
+# endif
+
+#define X(field, name)                                                        \
+  fields[StatFields::field] =                                                 \
+      (static_cast<double>(s->st_##name.tv_sec) * 1000) +                     \
+      (static_cast<double>(s->st_##name.tv_nsec / 1000000));                  \
+
+  X(kAtime, atim)
+  X(kMtime, mtim)
+  X(kCtime, ctim)
+  X(kBirthtime, birthtim)
+#undef X
+}
+
 static void Stat(const FunctionCallbackInfo<Value>& args) {
   Environment* env = Environment::GetCurrent(args.GetIsolate());
   HandleScope scope(env->isolate());
@@ -432,12 +512,20 @@ static void Stat(const FunctionCallbackInfo<Value>& args) {
 
   node::Utf8Value path(args[0]);
 
+  // Fill the Float64Array in args[2] instead of creating a fs.Stats object.
+  double* fields = GetStatsArray(args[2]);
+
   if (args[1]->IsFunction()) {
     ASYNC_CALL(stat, args[1], *path)
+    if (fields != NULL)
+      req_wrap->object()->Set(env->stat_values_string(), args[2]);
   } else {
     SYNC_CALL(stat, *path, *path)
-    args.GetReturnValue().Set(
-        BuildStatsObject(env, static_cast<const uv_stat_t*>(SYNC_REQ.ptr)));
+    const uv_stat_t* s = static_cast<const uv_stat_t*>(SYNC_REQ.ptr);
+    if (fields != NULL)
+      FillStatsArray(fields, s);
+    else
+      args.GetReturnValue().Set(BuildStatsObject(env, s));
   }
 }
 
@@ -452,12 +540,20 @@ static void LStat(const FunctionCallbackInfo<Value>& args) {
 
   node::Utf8Value path(args[0]);
 
+  // Fill the Float64Array in args[2] instead of creating a fs.Stats object.
+  double* fields = GetStatsArray(args[2]);
+
   if (args[1]->IsFunction()) {
     ASYNC_CALL(lstat, args[1], *path)
+    if (fields != NULL)
+      req_wrap->object()->Set(env->stat_values_string(), args[2]);
   } else {
     SYNC_CALL(lstat, *path, *path)
-    args.GetReturnValue().Set(
-        BuildStatsObject(env, static_cast<const uv_stat_t*>(SYNC_REQ.ptr)));
+    const uv_stat_t* s = static_cast<const uv_stat_t*>(SYNC_REQ.ptr);
+    if (fields != NULL)
+      FillStatsArray(fields, s);
+    else
+      args.GetReturnValue().Set(BuildStatsObject(env, s));
   }
 }
 
@@ -471,12 +567,20 @@ static void FStat(const FunctionCallbackInfo<Value>& args) {
 
   int fd = args[0]->Int32Value();
 
+  // Fill the Float64Array in args[2] instead of creating a fs.Stats object.
+  double* fields = GetStatsArray(args[2]);
+
   if (args[1]->IsFunction()) {
     ASYNC_CALL(fstat, args[1], fd)
+    if (fields != NULL)
+      req_wrap->object()->Set(env->stat_values_string(), args[2]);
   } else {
     SYNC_CALL(fstat, 0, fd)
-    args.GetReturnValue().Set(
-        BuildStatsObject(env, static_cast<const uv_stat_t*>(SYNC_REQ.ptr)));
+    const uv_stat_t* s = static_cast<const uv_stat_t*>(SYNC_REQ.ptr);
+    if (fields != NULL)
+      FillStatsArray(fields, s);
+    else
+      args.GetReturnValue().Set(BuildStatsObject(env, s));
   }
 }
 
@@ -940,6 +1044,1179 @@ static void Read(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+#ifndef _WIN32
+
+// Reads or writes a whole file with a single threadpool job rather than the
+// open/fstat/read/close round trips that lib/fs.js makes otherwise.  The
+// work functions run on the threadpool, or inline for the sync variants, and
+// use raw system calls because uv_fs_*() touches the event loop even in
+// synchronous mode.
+class WholeFileReqWrap : public ReqWrap<uv_work_t> {
+ public:
+  WholeFileReqWrap(Environment* env,
+                   Local<Object> object,
+                   const char* path,
+                   int flags,
+                   int mode)
+      : ReqWrap<uv_work_t>(env, object),
+        path_(strdup(path)),
+        flags_(flags),
+        mode_(mode),
+        fsync_(false),
+        owns_data_(false),
+        data_(NULL),
+        size_(0),
+        err_(0),
+        syscall_(NULL),
+        too_large_(false) {
+  }
+
+  ~WholeFileReqWrap() {
+    free(path_);
+    if (owns_data_)
+      free(data_);
+  }
+
+  static void Read(uv_work_t* req);
+  static void Write(uv_work_t* req);
+  static void After(uv_work_t* req, int status);
+
+  // Returns the error for a failed request, as a sync call throws it or as
+  // an async call passes it to the callback.
+  Local<Value> Error(bool sync) const;
+
+  // Hands the data over to a Buffer, ownership included.
+  Local<Object> ReleaseData();
+
+  char* path_;
+  int flags_;
+  int mode_;
+  bool fsync_;
+  bool owns_data_;  // True if data_ is ours, false if it belongs to a Buffer.
+  char* data_;
+  size_t size_;
+  int err_;
+  const char* syscall_;
+  bool too_large_;
+};
+
+
+static int OpenWholeFile(WholeFileReqWrap* req) {
+  int flags = req->flags_;
+#ifdef O_CLOEXEC
+  flags |= O_CLOEXEC;
+#endif
+  int fd;
+  do
+    fd = open(req->path_, flags, req->mode_);
+  while (fd == -1 && errno == EINTR);
+  if (fd == -1) {
+    req->err_ = -errno;
+    req->syscall_ = "open";
+  }
+  return fd;
+}
+
+
+static void CloseWholeFile(WholeFileReqWrap* req, int fd) {
+  if (close(fd) == -1 && errno != EINTR && req->err_ == 0) {
+    req->err_ = -errno;
+    req->syscall_ = "close";
+  }
+}
+
+
+void WholeFileReqWrap::Read(uv_work_t* work_req) {
+  WholeFileReqWrap* req = ContainerOf(&WholeFileReqWrap::req_, work_req);
+  req->owns_data_ = true;
+
+  int fd = OpenWholeFile(req);
+  if (fd == -1)
+    return;
+
+  struct stat s;
+  if (fstat(fd, &s) == -1) {
+    req->err_ = -errno;
+    req->syscall_ = "fstat";
+    return CloseWholeFile(req, fd);
+  }
+
+  // Files in e.g. /proc report a size of zero, read until EOF for those.
+  size_t size = s.st_size;
+  if (size > Buffer::kMaxLength) {
+    req->too_large_ = true;
+    return CloseWholeFile(req, fd);
+  }
+
+  size_t capacity = size > 0 ? size : 8192;
+  size_t length = 0;
+  char* data = static_cast<char*>(malloc(capacity));
+  if (data == NULL)
+    FatalError("node::WholeFileReqWrap::Read()", "Out of Memory");
+
+  for (;;) {
+    if (length == capacity) {
+      if (size > 0)
+        break;
+      if (capacity == Buffer::kMaxLength) {
+        req->too_large_ = true;
+        break;
+      }
+      capacity = MIN(2 * capacity, Buffer::kMaxLength);
+      data = static_cast<char*>(realloc(data, capacity));
+      if (data == NULL)
+        FatalError("node::WholeFileReqWrap::Read()", "Out of Memory");
+    }
+
+    ssize_t nread;
+    do
+      nread = read(fd, data + length, capacity - length);
+    while (nread == -1 && errno == EINTR);
+
+    if (nread == -1) {
+      req->err_ = -errno;
+      req->syscall_ = "read";
+      break;
+    }
+
+    if (nread == 0)
+      break;
+
+    length += nread;
+  }
+
+  // Give back the slack from growing the buffer.
+  if (length > 0 && length < capacity) {
+    char* trimmed = static_cast<char*>(realloc(data, length));
+    if (trimmed != NULL)
+      data = trimmed;
+  }
+
+  req->data_ = data;
+  req->size_ = length;
+  CloseWholeFile(req, fd);
+}
+
+
+void WholeFileReqWrap::Write(uv_work_t* work_req) {
+  WholeFileReqWrap* req = ContainerOf(&WholeFileReqWrap::req_, work_req);
+
+  int fd = OpenWholeFile(req);
+  if (fd == -1)
+    return;
+
+  // Append mode writes at the end of the file, like fs.writeFile() does.
+  size_t written = 0;
+  while (written < req->size_) {
+    ssize_t nwritten;
+    do
+      nwritten = write(fd, req->data_ + written, req->size_ - written);
+    while (nwritten == -1 && errno == EINTR);
+
+    if (nwritten == -1) {
+      req->err_ = -errno;
+      req->syscall_ = "write";
+      break;
+    }
+
+    written += nwritten;
+  }
+
+  if (req->err_ == 0 && req->fsync_ && fsync(fd) == -1) {
+    req->err_ = -errno;
+    req->syscall_ = "fsync";
+  }
+
+  CloseWholeFile(req, fd);
+}
+
+
+Local<Value> WholeFileReqWrap::Error(bool sync) const {
+  if (too_large_) {
+    return v8::Exception::RangeError(FIXED_ONE_BYTE_STRING(env()->isolate(),
+        "File size is greater than possible Buffer: 0x3FFFFFFF bytes"));
+  }
+  // Only open() errors include the path, like the non-native fs.readFile().
+  const char* path = strcmp(syscall_, "open") == 0 ? path_ : NULL;
+  if (sync)
+    return UVException(env()->isolate(), err_, syscall_, "", path);
+  return UVException(env()->isolate(), err_, NULL, syscall_, path);
+}
+
+
+Local<Object> WholeFileReqWrap::ReleaseData() {
+  if (size_ == 0)
+    return Buffer::New(env(), 0);
+  Local<Object> buffer = Buffer::Use(env(), data_, size_);
+  owns_data_ = false;
+  data_ = NULL;
+  return buffer;
+}
+
+
+void WholeFileReqWrap::After(uv_work_t* work_req, int status) {
+  assert(status == 0);
+  WholeFileReqWrap* req = ContainerOf(&WholeFileReqWrap::req_, work_req);
+  Environment* env = req->env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+
+  Local<Value> argv[2];
+  int argc = 1;
+
+  if (req->err_ != 0 || req->too_large_) {
+    argv[0] = req->Error(false);
+  } else {
+    argv[0] = Null(env->isolate());
+    if (req->owns_data_) {
+      argv[1] = req->ReleaseData();
+      argc = 2;
+    }
+  }
+
+  req->MakeCallback(env->oncomplete_string(), argc, argv);
+  delete req;
+}
+
+
+/*
+ * Reads a whole file.
+ *
+ * buffer = fs.readFile(path, flags, mode, callback)
+ *
+ * 0 path      string
+ * 1 flags     integer. open(2) flags
+ * 2 mode      integer. creation mode
+ * 3 callback  optional. called with (err, buffer), sync call if absent
+ *
+ */
+static void ReadFile(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args.GetIsolate());
+  HandleScope scope(env->isolate());
+
+  if (!args[0]->IsString())
+    return TYPE_ERROR("path must be a string");
+  if (!args[1]->IsInt32())
+    return TYPE_ERROR("flags must be an int");
+  if (!args[2]->IsInt32())
+    return TYPE_ERROR("mode must be an int");
+
+  node::Utf8Value path(args[0]);
+  int flags = args[1]->Int32Value();
+  int mode = args[2]->Int32Value();
+
+  WholeFileReqWrap* req = new WholeFileReqWrap(env,
+                                               Object::New(env->isolate()),
+                                               *path,
+                                               flags,
+                                               mode);
+  req->Dispatched();
+
+  if (args[3]->IsFunction()) {
+    req->object()->Set(env->oncomplete_string(), args[3]);
+    uv_queue_work(env->event_loop(),
+                  &req->req_,
+                  WholeFileReqWrap::Read,
+                  WholeFileReqWrap::After);
+    return args.GetReturnValue().Set(req->persistent());
+  }
+
+  WholeFileReqWrap::Read(&req->req_);
+  if (req->err_ != 0 || req->too_large_)
+    env->isolate()->ThrowException(req->Error(true));
+  else
+    args.GetReturnValue().Set(req->ReleaseData());
+  delete req;
+}
+
+
+/*
+ * Writes a whole file.
+ *
+ * fs.writeFile(path, buffer, flags, mode, fsync, callback)
+ *
+ * 0 path      string
+ * 1 buffer    instance of Buffer
+ * 2 flags     integer. open(2) flags
+ * 3 mode      integer. creation mode
+ * 4 fsync     boolean. fsync(2) before closing the file
+ * 5 callback  optional. called with (err), sync call if absent
+ *
+ */
+static void WriteFile(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args.GetIsolate());
+  HandleScope scope(env->isolate());
+
+  if (!args[0]->IsString())
+    return TYPE_ERROR("path must be a string");
+  if (!Buffer::HasInstance(args[1]))
+    return TYPE_ERROR("data must be a buffer");
+  if (!args[2]->IsInt32())
+    return TYPE_ERROR("flags must be an int");
+  if (!args[3]->IsInt32())
+    return TYPE_ERROR("mode must be an int");
+
+  node::Utf8Value path(args[0]);
+  Local<Object> buffer = args[1].As<Object>();
+  int flags = args[2]->Int32Value();
+  int mode = args[3]->Int32Value();
+
+  WholeFileReqWrap* req = new WholeFileReqWrap(env,
+                                               Object::New(env->isolate()),
+                                               *path,
+                                               flags,
+                                               mode);
+  req->Dispatched();
+  req->owns_data_ = false;
+  req->data_ = Buffer::Data(buffer);
+  req->size_ = Buffer::Length(buffer);
+  req->fsync_ = args[4]->IsTrue();
+
+  if (args[5]->IsFunction()) {
+    // Keeps the buffer alive while the threadpool writes it out.
+    req->object()->Set(env->buffer_string(), buffer);
+    req->object()->Set(env->oncomplete_string(), args[5]);
+    uv_queue_work(env->event_loop(),
+                  &req->req_,
+                  WholeFileReqWrap::Write,
+                  WholeFileReqWrap::After);
+    return args.GetReturnValue().Set(req->persistent());
+  }
+
+  WholeFileReqWrap::Write(&req->req_);
+  if (req->err_ != 0)
+    env->isolate()->ThrowException(req->Error(true));
+  delete req;
+}
+
+
+// Mirrors uv__to_stat() in deps/uv/src/unix/fs.c.
+static void StatToUvStat(const struct stat* src, uv_stat_t* dst) {
+  memset(dst, 0, sizeof(*dst));
+  dst->st_dev = src->st_dev;
+  dst->st_mode = src->st_mode;
+  dst->st_nlink = src->st_nlink;
+  dst->st_uid = src->st_uid;
+  dst->st_gid = src->st_gid;
+  dst->st_rdev = src->st_rdev;
+  dst->st_ino = src->st_ino;
+  dst->st_size = src->st_size;
+  dst->st_blksize = src->st_blksize;
+  dst->st_blocks = src->st_blocks;
+#if defined(__APPLE__)
+  dst->st_atim.tv_sec = src->st_atimespec.tv_sec;
+  dst->st_atim.tv_nsec = src->st_atimespec.tv_nsec;
+  dst->st_mtim.tv_sec = src->st_mtimespec.tv_sec;
+  dst->st_mtim.tv_nsec = src->st_mtimespec.tv_nsec;
+  dst->st_ctim.tv_sec = src->st_ctimespec.tv_sec;
+  dst->st_ctim.tv_nsec = src->st_ctimespec.tv_nsec;
+  dst->st_birthtim.tv_sec = src->st_birthtimespec.tv_sec;
+  dst->st_birthtim.tv_nsec = src->st_birthtimespec.tv_nsec;
+#elif !defined(_AIX) && \
+  (defined(_BSD_SOURCE) || defined(_SVID_SOURCE) || defined(_XOPEN_SOURCE))
+  dst->st_atim.tv_sec = src->st_atim.tv_sec;
+  dst->st_atim.tv_nsec = src->st_atim.tv_nsec;
+  dst->st_mtim.tv_sec = src->st_mtim.tv_sec;
+  dst->st_mtim.tv_nsec = src->st_mtim.tv_nsec;
+  dst->st_ctim.tv_sec = src->st_ctim.tv_sec;
+  dst->st_ctim.tv_nsec = src->st_ctim.tv_nsec;
+# if defined(__DragonFly__)  || \
+     defined(__FreeBSD__)    || \
+     defined(__OpenBSD__)    || \
+     defined(__NetBSD__)
+  dst->st_birthtim.tv_sec = src->st_birthtim.tv_sec;
+  dst->st_birthtim.tv_nsec = src->st_birthtim.tv_nsec;
+# else
+  dst->st_birthtim.tv_sec = src->st_ctim.tv_sec;
+  dst->st_birthtim.tv_nsec = src->st_ctim.tv_nsec;
+# endif
+#else
+  dst->st_atim.tv_sec = src->st_atime;
+  dst->st_mtim.tv_sec = src->st_mtime;
+  dst->st_ctim.tv_sec = src->st_ctime;
+  dst->st_birthtim.tv_sec = src->st_ctime;
+#endif
+}
+
+
+// Stats a list of paths in one threadpool job.  Results are written to a
+// Float64Array, Environment::StatFields::kFieldsCount values per path, and
+// errors to an Int32Array, one libuv error code (or zero) per path.
+class StatManyReqWrap : public ReqWrap<uv_work_t> {
+ public:
+  StatManyReqWrap(Environment* env,
+                  Local<Object> object,
+                  Local<Array> paths,
+                  double* values,
+                  int32_t* errors);
+  ~StatManyReqWrap() {
+    delete[] paths_;
+    delete[] storage_;
+  }
+
+  static void Work(uv_work_t* req);
+  static void After(uv_work_t* req, int status);
+
+ private:
+  const char** paths_;
+  char* storage_;
+  uint32_t count_;
+  double* values_;
+  int32_t* errors_;
+};
+
+
+StatManyReqWrap::StatManyReqWrap(Environment* env,
+                                 Local<Object> object,
+                                 Local<Array> paths,
+                                 double* values,
+                                 int32_t* errors)
+    : ReqWrap<uv_work_t>(env, object),
+      paths_(NULL),
+      storage_(NULL),
+      count_(paths->Length()),
+      values_(values),
+      errors_(errors) {
+  // Copy the paths into a single block of memory, the threadpool can't
+  // touch the JS heap.
+  size_t size = 0;
+  for (uint32_t i = 0; i < count_; i++)
+    size += paths->Get(i).As<String>()->Utf8Length() + 1;
+
+  paths_ = new const char*[count_];
+  storage_ = new char[size];
+
+  char* p = storage_;
+  for (uint32_t i = 0; i < count_; i++) {
+    Local<String> path = paths->Get(i).As<String>();
+    paths_[i] = p;
+    p += path->WriteUtf8(p);
+  }
+}
+
+
+void StatManyReqWrap::Work(uv_work_t* work_req) {
+  StatManyReqWrap* req = ContainerOf(&StatManyReqWrap::req_, work_req);
+  const int kFieldsCount = Environment::StatFields::kFieldsCount;
+
+  for (uint32_t i = 0; i < req->count_; i++) {
+    struct stat s;
+    if (stat(req->paths_[i], &s) == -1) {
+      req->errors_[i] = -errno;
+      continue;
+    }
+    uv_stat_t uv_stat;
+    StatToUvStat(&s, &uv_stat);
+    FillStatsArray(req->values_ + i * kFieldsCount, &uv_stat);
+    req->errors_[i] = 0;
+  }
+}
+
+
+void StatManyReqWrap::After(uv_work_t* work_req, int status) {
+  assert(status == 0);
+  StatManyReqWrap* req = ContainerOf(&StatManyReqWrap::req_, work_req);
+  Environment* env = req->env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+  Local<Value> arg = Null(env->isolate());
+  req->MakeCallback(env->oncomplete_string(), 1, &arg);
+  delete req;
+}
+
+
+/*
+ * Stats many paths at once.
+ *
+ * fs.statMany(paths, values, errors, callback)
+ *
+ * 0 paths     array of strings
+ * 1 values    Float64Array, kFieldsCount entries per path
+ * 2 errors    Int32Array, one entry per path
+ * 3 callback  called with (null) when all paths have been stat'ed
+ *
+ */
+static void StatMany(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args.GetIsolate());
+  HandleScope scope(env->isolate());
+
+  if (!args[0]->IsArray())
+    return TYPE_ERROR("paths must be an array");
+  if (!args[3]->IsFunction())
+    return TYPE_ERROR("callback must be a function");
+
+  Local<Array> paths = args[0].As<Array>();
+  uint32_t count = paths->Length();
+  for (uint32_t i = 0; i < count; i++) {
+    if (!paths->Get(i)->IsString())
+      return TYPE_ERROR("path must be a string");
+  }
+
+  if (!args[1]->IsObject() || !args[2]->IsObject())
+    return THROW_BAD_ARGS;
+
+  Local<Object> values = args[1].As<Object>();
+  Local<Object> errors = args[2].As<Object>();
+  if (!values->HasIndexedPropertiesInExternalArrayData() ||
+      values->GetIndexedPropertiesExternalArrayDataType() !=
+          kExternalFloat64Array ||
+      static_cast<uint32_t>(
+          values->GetIndexedPropertiesExternalArrayDataLength()) <
+          count * Environment::StatFields::kFieldsCount) {
+    return TYPE_ERROR("values must be a big enough Float64Array");
+  }
+
+  if (!errors->HasIndexedPropertiesInExternalArrayData() ||
+      errors->GetIndexedPropertiesExternalArrayDataType() !=
+          kExternalInt32Array ||
+      static_cast<uint32_t>(
+          errors->GetIndexedPropertiesExternalArrayDataLength()) < count) {
+    return TYPE_ERROR("errors must be a big enough Int32Array");
+  }
+
+  StatManyReqWrap* req = new StatManyReqWrap(
+      env,
+      Object::New(env->isolate()),
+      paths,
+      static_cast<double*>(values->GetIndexedPropertiesExternalArrayData()),
+      static_cast<int32_t*>(errors->GetIndexedPropertiesExternalArrayData()));
+  req->Dispatched();
+
+  // Keeps the arrays alive while the threadpool fills them in.
+  req->object()->Set(env->stat_values_string(), values);
+  req->object()->Set(env->errno_string(), errors);
+  req->object()->Set(env->oncomplete_string(), args[3]);
+  uv_queue_work(env->event_loop(),
+                &req->req_,
+                StatManyReqWrap::Work,
+                StatManyReqWrap::After);
+  args.GetReturnValue().Set(req->persistent());
+}
+
+
+// Walks a directory tree on the threadpool and hands the entries back to JS
+// in batches, one threadpool job per batch.  Entry types come from d_type so
+// callers don't have to stat every entry; the file system is only asked
+// when it doesn't fill in d_type.  Symbolic links are reported but never
+// followed.  fs.readdir() with the `types` option is a walk with a maximum
+// depth of zero.
+class DirWalker : public ReqWrap<uv_work_t> {
+ public:
+  static const int kBatchSize = 1024;
+
+  DirWalker(Environment* env,
+            Local<Object> object,
+            const char* root,
+            int max_depth,
+            Local<Array> exclude);
+  ~DirWalker();
+
+  static void Work(uv_work_t* req);
+  static void After(uv_work_t* req, int status);
+
+ private:
+  struct Dir {
+    DIR* dir;
+    char* path;  // Relative to the root, empty for the root itself.
+    int depth;
+    Dir* parent;
+  };
+
+  bool PushDir(const char* path, int depth);
+  void PopDir();
+  bool IsExcluded(const char* name) const;
+  void AddEntry(const char* path, int type);
+  void SetError(const char* syscall, const char* path);
+  char* FullPath(const char* path) const;
+
+  char* root_;
+  int max_depth_;
+  char** exclude_;
+  uint32_t exclude_count_;
+  Dir* top_;
+  bool started_;
+  bool done_;
+  int err_;
+  const char* syscall_;
+  char* err_path_;
+  // The current batch, paths are stored back to back, zero terminated.
+  char* paths_;
+  size_t paths_length_;
+  size_t paths_capacity_;
+  int types_[kBatchSize];
+  int count_;
+};
+
+
+DirWalker::DirWalker(Environment* env,
+                     Local<Object> object,
+                     const char* root,
+                     int max_depth,
+                     Local<Array> exclude)
+    : ReqWrap<uv_work_t>(env, object),
+      root_(strdup(root)),
+      max_depth_(max_depth),
+      exclude_(NULL),
+      exclude_count_(exclude->Length()),
+      top_(NULL),
+      started_(false),
+      done_(false),
+      err_(0),
+      syscall_(NULL),
+      err_path_(NULL),
+      paths_(NULL),
+      paths_length_(0),
+      paths_capacity_(0),
+      count_(0) {
+  exclude_ = new char*[exclude_count_];
+  for (uint32_t i = 0; i < exclude_count_; i++) {
+    node::Utf8Value name(exclude->Get(i));
+    exclude_[i] = strdup(*name);
+  }
+}
+
+
+DirWalker::~DirWalker() {
+  while (top_ != NULL)
+    PopDir();
+  for (uint32_t i = 0; i < exclude_count_; i++)
+    free(exclude_[i]);
+  delete[] exclude_;
+  free(root_);
+  free(err_path_);
+  free(paths_);
+}
+
+
+char* DirWalker::FullPath(const char* path) const {
+  size_t root_length = strlen(root_);
+  size_t path_length = strlen(path);
+  char* full = static_cast<char*>(malloc(root_length + path_length + 2));
+  if (full == NULL)
+    FatalError("node::DirWalker::FullPath()", "Out of Memory");
+  memcpy(full, root_, root_length);
+  if (path_length > 0) {
+    full[root_length++] = '/';
+    memcpy(full + root_length, path, path_length);
+  }
+  full[root_length + path_length] = '\0';
+  return full;
+}
+
+
+void DirWalker::SetError(const char* syscall, const char* path) {
+  err_ = -errno;
+  syscall_ = syscall;
+  err_path_ = FullPath(path);
+}
+
+
+bool DirWalker::PushDir(const char* path, int depth) {
+  char* full = FullPath(path);
+  DIR* dir = opendir(full);
+  if (dir == NULL) {
+    SetError("opendir", path);
+    free(full);
+    return false;
+  }
+  free(full);
+  Dir* entry = new Dir;
+  entry->dir = dir;
+  entry->path = strdup(path);
+  entry->depth = depth;
+  entry->parent = top_;
+  top_ = entry;
+  return true;
+}
+
+
+void DirWalker::PopDir() {
+  Dir* entry = top_;
+  top_ = entry->parent;
+  closedir(entry->dir);
+  free(entry->path);
+  delete entry;
+}
+
+
+bool DirWalker::IsExcluded(const char* name) const {
+  for (uint32_t i = 0; i < exclude_count_; i++) {
+    if (strcmp(exclude_[i], name) == 0)
+      return true;
+  }
+  return false;
+}
+
+
+void DirWalker::AddEntry(const char* path, int type) {
+  size_t size = strlen(path) + 1;
+  if (paths_length_ + size > paths_capacity_) {
+    paths_capacity_ = MAX(2 * paths_capacity_, paths_length_ + size);
+    paths_ = static_cast<char*>(realloc(paths_, paths_capacity_));
+    if (paths_ == NULL)
+      FatalError("node::DirWalker::AddEntry()", "Out of Memory");
+  }
+  memcpy(paths_ + paths_length_, path, size);
+  paths_length_ += size;
+  types_[count_++] = type;
+}
+
+
+static int DirentType(const struct dirent* ent) {
+#ifdef DT_UNKNOWN
+  switch (ent->d_type) {
+    case DT_REG: return S_IFREG;
+    case DT_DIR: return S_IFDIR;
+    case DT_LNK: return S_IFLNK;
+    case DT_FIFO: return S_IFIFO;
+    case DT_SOCK: return S_IFSOCK;
+    case DT_CHR: return S_IFCHR;
+    case DT_BLK: return S_IFBLK;
+  }
+#endif
+  return 0;
+}
+
+
+void DirWalker::Work(uv_work_t* work_req) {
+  DirWalker* walker = ContainerOf(&DirWalker::req_, work_req);
+
+  if (!walker->started_) {
+    walker->started_ = true;
+    if (!walker->PushDir("", 0)) {
+      walker->done_ = true;
+      return;
+    }
+  }
+
+  char* path = NULL;
+  size_t path_capacity = 0;
+
+  while (walker->top_ != NULL && walker->count_ < kBatchSize) {
+    Dir* dir = walker->top_;
+
+    errno = 0;
+    struct dirent* ent = readdir(dir->dir);
+    if (ent == NULL) {
+      if (errno != 0) {
+        walker->SetError("readdir", dir->path);
+        break;
+      }
+      walker->PopDir();
+      continue;
+    }
+
+    const char* name = ent->d_name;
+    if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+      continue;
+    if (walker->IsExcluded(name))
+      continue;
+
+    size_t dir_length = strlen(dir->path);
+    size_t name_length = strlen(name);
+    size_t size = dir_length + name_length + 2;
+    if (size > path_capacity) {
+      path_capacity = MAX(size, 256);
+      path = static_cast<char*>(realloc(path, path_capacity));
+      if (path == NULL)
+        FatalError("node::DirWalker::Work()", "Out of Memory");
+    }
+    if (dir_length > 0) {
+      memcpy(path, dir->path, dir_length);
+      path[dir_length++] = '/';
+    }
+    memcpy(path + dir_length, name, name_length + 1);
+
+    int type = DirentType(ent);
+    if (type == 0) {
+      // Not every file system fills in d_type.
+      char* full = walker->FullPath(path);
+      struct stat s;
+      if (lstat(full, &s) == 0)
+        type = s.st_mode & S_IFMT;
+      free(full);
+    }
+
+    walker->AddEntry(path, type);
+
+    if (type == S_IFDIR &&
+        (walker->max_depth_ < 0 || dir->depth < walker->max_depth_)) {
+      if (!walker->PushDir(path, dir->depth + 1))
+        break;
+    }
+  }
+
+  free(path);
+  walker->done_ = walker->err_ != 0 || walker->top_ == NULL;
+}
+
+
+void DirWalker::After(uv_work_t* work_req, int status) {
+  assert(status == 0);
+  DirWalker* walker = ContainerOf(&DirWalker::req_, work_req);
+  Environment* env = walker->env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+
+  Local<Array> names = Array::New(env->isolate(), walker->count_);
+  Local<Array> types = Array::New(env->isolate(), walker->count_);
+  const char* path = walker->paths_;
+  for (int i = 0; i < walker->count_; i++) {
+    names->Set(i, String::NewFromUtf8(env->isolate(), path));
+    types->Set(i, Integer::New(env->isolate(), walker->types_[i]));
+    path += strlen(path) + 1;
+  }
+  walker->paths_length_ = 0;
+  walker->count_ = 0;
+
+  Local<Value> argv[] = {
+    Null(env->isolate()),
+    names,
+    types,
+    Boolean::New(env->isolate(), walker->done_)
+  };
+  if (walker->err_ != 0) {
+    argv[0] = UVException(env->isolate(),
+                          walker->err_,
+                          NULL,
+                          walker->syscall_,
+                          walker->err_path_);
+  }
+
+  // The callback returns false to stop the walk early.
+  Local<Value> ret =
+      walker->MakeCallback(env->oncomplete_string(), ARRAY_SIZE(argv), argv);
+
+  if (walker->done_ || ret.IsEmpty() || ret->IsFalse()) {
+    delete walker;
+    return;
+  }
+
+  uv_queue_work(env->event_loop(),
+                &walker->req_,
+                DirWalker::Work,
+                DirWalker::After);
+}
+
+
+/*
+ * Walks a directory tree.
+ *
+ * fs.walk(path, depth, exclude, callback)
+ *
+ * 0 path      string
+ * 1 depth     integer. how deep to descend, -1 for no limit
+ * 2 exclude   array of entry names to skip
+ * 3 callback  called with (err, paths, types, done) for every batch
+ *
+ */
+static void Walk(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args.GetIsolate());
+  HandleScope scope(env->isolate());
+
+  if (!args[0]->IsString())
+    return TYPE_ERROR("path must be a string");
+  if (!args[1]->IsInt32())
+    return TYPE_ERROR("depth must be an int");
+  if (!args[2]->IsArray())
+    return TYPE_ERROR("exclude must be an array");
+  if (!args[3]->IsFunction())
+    return TYPE_ERROR("callback must be a function");
+
+  node::Utf8Value path(args[0]);
+  DirWalker* walker = new DirWalker(env,
+                                    Object::New(env->isolate()),
+                                    *path,
+                                    args[1]->Int32Value(),
+                                    args[2].As<Array>());
+  walker->Dispatched();
+  walker->object()->Set(env->oncomplete_string(), args[3]);
+  uv_queue_work(env->event_loop(),
+                &walker->req_,
+                DirWalker::Work,
+                DirWalker::After);
+  args.GetReturnValue().Set(walker->persistent());
+}
+
+
+// Copies a file in a single threadpool job, or inline for the sync variant.
+// The data is copied by the kernel where possible: copy_file_range() first,
+// which can share extents on file systems that support it, then sendfile()
+// and finally a plain read/write loop.
+class CopyFileReqWrap : public ReqWrap<uv_work_t> {
+ public:
+  CopyFileReqWrap(Environment* env,
+                  Local<Object> object,
+                  const char* src,
+                  const char* dest,
+                  int flags)
+      : ReqWrap<uv_work_t>(env, object),
+        src_(strdup(src)),
+        dest_(strdup(dest)),
+        flags_(flags),
+        err_(0),
+        syscall_(NULL),
+        err_path_(NULL) {
+  }
+
+  ~CopyFileReqWrap() {
+    free(src_);
+    free(dest_);
+  }
+
+  static void Work(uv_work_t* req);
+  static void After(uv_work_t* req, int status);
+
+  // Returns the error for a failed request, as a sync call throws it or as
+  // an async call passes it to the callback.
+  Local<Value> Error(bool sync) const;
+
+  int err() const { return err_; }
+
+ private:
+  enum CopyResult { kCopyDone, kCopyError, kCopyUnsupported };
+
+  CopyResult CopyFileRange(int in, int out);
+  CopyResult SendFile(int in, int out);
+  void ReadWrite(int in, int out);
+  void SetError(const char* syscall, const char* path);
+
+  char* src_;
+  char* dest_;
+  int flags_;
+  int err_;
+  const char* syscall_;
+  const char* err_path_;
+};
+
+
+void CopyFileReqWrap::SetError(const char* syscall, const char* path) {
+  err_ = -errno;
+  syscall_ = syscall;
+  err_path_ = path;
+}
+
+
+CopyFileReqWrap::CopyResult CopyFileReqWrap::CopyFileRange(int in, int out) {
+#if defined(__linux__) && defined(__NR_copy_file_range)
+  for (bool first = true;; first = false) {
+    ssize_t n;
+    do
+      n = syscall(__NR_copy_file_range, in, NULL, out, NULL, 1 << 30, 0);
+    while (n == -1 && errno == EINTR);
+
+    // Only called for files with a size, nothing copied means the kernel
+    // can't copy this one.  Linux 5.3 to 5.18 do that for sysfs files.
+    if (n == 0)
+      return first ? kCopyUnsupported : kCopyDone;
+
+    if (n == -1) {
+      // Not supported by the kernel or across these file systems.  Only safe
+      // to fall back when nothing has been copied yet.
+      if (first && (errno == ENOSYS || errno == EXDEV || errno == EINVAL ||
+                    errno == EOPNOTSUPP || errno == EPERM)) {
+        return kCopyUnsupported;
+      }
+      SetError("copy_file_range", src_);
+      return kCopyError;
+    }
+  }
+#else
+  return kCopyUnsupported;
+#endif
+}
+
+
+CopyFileReqWrap::CopyResult CopyFileReqWrap::SendFile(int in, int out) {
+#if defined(__linux__)
+  for (bool first = true;; first = false) {
+    ssize_t n;
+    do
+      n = sendfile(out, in, NULL, 1 << 30);
+    while (n == -1 && errno == EINTR);
+
+    // See CopyFileRange().
+    if (n == 0)
+      return first ? kCopyUnsupported : kCopyDone;
+
+    if (n == -1) {
+      // Kernels before 2.6.33 only accept sockets as the destination.
+      if (first && (errno == EINVAL || errno == ENOSYS))
+        return kCopyUnsupported;
+      SetError("sendfile", src_);
+      return kCopyError;
+    }
+  }
+#else
+  return kCopyUnsupported;
+#endif
+}
+
+
+void CopyFileReqWrap::ReadWrite(int in, int out) {
+  char buf[65536];
+
+  for (;;) {
+    ssize_t nread;
+    do
+      nread = read(in, buf, sizeof(buf));
+    while (nread == -1 && errno == EINTR);
+
+    if (nread == 0)
+      return;
+
+    if (nread == -1)
+      return SetError("read", src_);
+
+    ssize_t written = 0;
+    while (written < nread) {
+      ssize_t n;
+      do
+        n = write(out, buf + written, nread - written);
+      while (n == -1 && errno == EINTR);
+
+      if (n == -1)
+        return SetError("write", dest_);
+
+      written += n;
+    }
+  }
+}
+
+
+void CopyFileReqWrap::Work(uv_work_t* work_req) {
+  CopyFileReqWrap* req = ContainerOf(&CopyFileReqWrap::req_, work_req);
+  int cloexec = 0;
+#ifdef O_CLOEXEC
+  cloexec = O_CLOEXEC;
+#endif
+
+  int in;
+  do
+    in = open(req->src_, O_RDONLY | cloexec);
+  while (in == -1 && errno == EINTR);
+  if (in == -1)
+    return req->SetError("open", req->src_);
+
+  struct stat s;
+  if (fstat(in, &s) == -1) {
+    req->SetError("fstat", req->src_);
+    close(in);
+    return;
+  }
+
+  // Opening the destination truncates it, don't let that eat the source.
+  struct stat d;
+  if (stat(req->dest_, &d) == 0 &&
+      d.st_dev == s.st_dev &&
+      d.st_ino == s.st_ino) {
+    errno = EINVAL;
+    req->SetError("copyfile", req->dest_);
+    close(in);
+    return;
+  }
+
+  int out;
+  do
+    out = open(req->dest_, req->flags_ | cloexec, s.st_mode & 0777);
+  while (out == -1 && errno == EINTR);
+  if (out == -1) {
+    req->SetError("open", req->dest_);
+    close(in);
+    return;
+  }
+
+  // Files in e.g. /proc report a size of zero and the in-kernel copies
+  // treat that as end of file.
+  // copy_file_range() rejects O_APPEND destinations with EBADF.
+  CopyResult result = kCopyUnsupported;
+  if (s.st_size > 0) {
+    if ((req->flags_ & O_APPEND) == 0)
+      result = req->CopyFileRange(in, out);
+    if (result == kCopyUnsupported)
+      result = req->SendFile(in, out);
+  }
+  if (result == kCopyUnsupported)
+    req->ReadWrite(in, out);
+
+  close(in);
+  if (close(out) == -1 && errno != EINTR && req->err_ == 0)
+    req->SetError("close", req->dest_);
+}
+
+
+Local<Value> CopyFileReqWrap::Error(bool sync) const {
+  if (sync)
+    return UVException(env()->isolate(), err_, syscall_, "", err_path_);
+  return UVException(env()->isolate(), err_, NULL, syscall_, err_path_);
+}
+
+
+void CopyFileReqWrap::After(uv_work_t* work_req, int status) {
+  assert(status == 0);
+  CopyFileReqWrap* req = ContainerOf(&CopyFileReqWrap::req_, work_req);
+  Environment* env = req->env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+
+  Local<Value> arg = Null(env->isolate());
+  if (req->err_ != 0)
+    arg = req->Error(false);
+
+  req->MakeCallback(env->oncomplete_string(), 1, &arg);
+  delete req;
+}
+
+
+/*
+ * Copies a file.
+ *
+ * fs.copyFile(src, dest, flags, callback)
+ *
+ * 0 src       string
+ * 1 dest      string
+ * 2 flags     integer. open(2) flags for dest
+ * 3 callback  optional. called with (err), sync call if absent
+ *
+ */
+static void CopyFile(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args.GetIsolate());
+  HandleScope scope(env->isolate());
+
+  if (!args[0]->IsString())
+    return TYPE_ERROR("src must be a string");
+  if (!args[1]->IsString())
+    return TYPE_ERROR("dest must be a string");
+  if (!args[2]->IsInt32())
+    return TYPE_ERROR("flags must be an int");
+
+  node::Utf8Value src(args[0]);
+  node::Utf8Value dest(args[1]);
+  CopyFileReqWrap* req = new CopyFileReqWrap(env,
+                                             Object::New(env->isolate()),
+                                             *src,
+                                             *dest,
+                                             args[2]->Int32Value());
+  req->Dispatched();
+
+  if (args[3]->IsFunction()) {
+    req->object()->Set(env->oncomplete_string(), args[3]);
+    uv_queue_work(env->event_loop(),
+                  &req->req_,
+                  CopyFileReqWrap::Work,
+                  CopyFileReqWrap::After);
+    return args.GetReturnValue().Set(req->persistent());
+  }
+
+  CopyFileReqWrap::Work(&req->req_);
+  if (req->err() != 0)
+    env->isolate()->ThrowException(req->Error(true));
+  delete req;
+}
+
+#endif  // !_WIN32
+
+
 /* fs.chmod(path, mode);
  * Wrapper for chmod(1) / EIO_CHMOD
  */
@@ -1125,6 +2402,17 @@ void InitFs(Handle<Object> target,
       FIXED_ONE_BYTE_STRING(env->isolate(), "FSInitialize"),
       FunctionTemplate::New(env->isolate(), FSInitialize)->GetFunction());
 
+  Environment::StatFields* stat_fields = env->stat_fields();
+  Local<Object> stat_values = Object::New(env->isolate());
+  stat_values->SetIndexedPropertiesToExternalArrayData(
+      stat_fields->fields(),
+      kExternalFloat64Array,
+      stat_fields->fields_count());
+  // Lets JS size its own arrays for multiple stat results.
+  stat_values->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "length"),
+                   Integer::New(env->isolate(), stat_fields->fields_count()));
+  target->Set(env->stat_values_string(), stat_values);
+
   NODE_SET_METHOD(target, "close", Close);
   NODE_SET_METHOD(target, "open", Open);
   NODE_SET_METHOD(target, "read", Read);
@@ -1144,6 +2432,13 @@ void InitFs(Handle<Object> target,
   NODE_SET_METHOD(target, "unlink", Unlink);
   NODE_SET_METHOD(target, "writeBuffer", WriteBuffer);
   NODE_SET_METHOD(target, "writeString", WriteString);
+#ifndef _WIN32
+  NODE_SET_METHOD(target, "readFile", ReadFile);
+  NODE_SET_METHOD(target, "writeFile", WriteFile);
+  NODE_SET_METHOD(target, "statMany", StatMany);
+  NODE_SET_METHOD(target, "walk", Walk);
+  NODE_SET_METHOD(target, "copyFile", CopyFile);
+#endif
 
   NODE_SET_METHOD(target, "chmod", Chmod);
   NODE_SET_METHOD(target, "fchmod", FChmod);
@@ -38,8 +38,40 @@ using v8::Local;
 using v8::Object;
 using v8::String;
 
+// js2c guarantees that the sources are pure ASCII, so they can be handed to
+// V8 as-is instead of being copied into the heap.  The resource only owns
+// itself, the data is static and never freed.
+class NativeSourceResource : public String::ExternalOneByteStringResource {
+ public:
+  NativeSourceResource(const char* data, size_t length)
+      : data_(data),
+        length_(length) {
+  }
+
+  const char* data() const {
+    return data_;
+  }
+
+  size_t length() const {
+    return length_;
+  }
+
+ private:
+  const char* data_;
+  size_t length_;
+};
+
+
+static Local<String> NativeSource(Environment* env,
+                                  const char* data,
+                                  size_t length) {
+  return String::NewExternal(env->isolate(),
+                             new NativeSourceResource(data, length));
+}
+
+
 Handle<String> MainSource(Environment* env) {
-  return OneByteString(env->isolate(), node_native, sizeof(node_native) - 1);
+  return NativeSource(env, node_native, sizeof(node_native) - 1);
 }
 
 void DefineJavaScript(Environment* env, Handle<Object> target) {
@@ -48,10 +80,9 @@ void DefineJavaScript(Environment* env, Handle<Object> target) {
   for (int i = 0; natives[i].name; i++) {
     if (natives[i].source != node_native) {
       Local<String> name = String::NewFromUtf8(env->isolate(), natives[i].name);
-      Handle<String> source = String::NewFromUtf8(env->isolate(),
-                                                  natives[i].source,
-                                                  String::kNormalString,
-                                                  natives[i].source_len);
+      Handle<String> source = NativeSource(env,
+                                           natives[i].source,
+                                           natives[i].source_len);
       target->Set(name, source);
     }
   }
@@ -0,0 +1,102 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "node_counters.h"
+#include "node_linux_perfctr_provider.h"
+#include "uv.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace node {
+
+NodeCounterSegment* node_counter_segment;
+static char segment_name[32];
+
+
+static void UnlinkSegment() {
+  // Only the process that created the segment removes it, not the children
+  // that inherited the atexit handler through fork().
+  if (node_counter_segment != NULL &&
+      node_counter_segment->pid == static_cast<uint32_t>(getpid())) {
+    shm_unlink(segment_name);
+  }
+}
+
+
+void InitPerfCountersLinux() {
+  if (node_counter_segment != NULL)
+    return;
+
+  snprintf(segment_name,
+           sizeof(segment_name),
+           "/node-%u",
+           static_cast<unsigned int>(getpid()));
+
+  // A leftover segment from a process that had the same pid is replaced.
+  shm_unlink(segment_name);
+  int fd = shm_open(segment_name, O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd == -1)
+    return;
+
+  const size_t size = sizeof(*node_counter_segment);
+  void* base = MAP_FAILED;
+  if (ftruncate(fd, size) == 0)
+    base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (base == MAP_FAILED) {
+    shm_unlink(segment_name);
+    return;
+  }
+
+  // ftruncate() zero-fills the segment.  The header is written last so
+  // readers never see a valid magic with an incomplete header.
+  NodeCounterSegment* segment = static_cast<NodeCounterSegment*>(base);
+  segment->version = kNodeCounterVersion;
+  segment->pid = getpid();
+  segment->count = NODE_COUNTER_MAX;
+  __sync_synchronize();
+  segment->magic = kNodeCounterMagic;
+  node_counter_segment = segment;
+
+  atexit(UnlinkSegment);
+}
+
+
+void TermPerfCountersLinux() {
+  if (node_counter_segment == NULL)
+    return;
+  UnlinkSegment();
+  munmap(node_counter_segment, sizeof(*node_counter_segment));
+  node_counter_segment = NULL;
+}
+
+
+uint64_t NODE_COUNT_GET_GC_RAWTIME() {
+  return uv_hrtime();
+}
+
+}  // namespace node
@@ -0,0 +1,122 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#ifndef SRC_NODE_LINUX_PERFCTR_PROVIDER_H_
+#define SRC_NODE_LINUX_PERFCTR_PROVIDER_H_
+
+#include <stdint.h>
+
+namespace node {
+
+// The counters live in a POSIX shared memory segment called /node-<pid>,
+// i.e. /dev/shm/node-<pid>, so that an external agent can read them
+// without involving the process.  See tools/perfctr.py for a reader.
+//
+// The layout is part of the ABI, only ever append counters.  All fields
+// are native endian and naturally aligned; the counters are written by
+// the main thread only.
+enum NodeCounter {
+  NODE_COUNTER_HTTP_SERVER_REQUEST,
+  NODE_COUNTER_HTTP_SERVER_RESPONSE,
+  NODE_COUNTER_HTTP_CLIENT_REQUEST,
+  NODE_COUNTER_HTTP_CLIENT_RESPONSE,
+  NODE_COUNTER_SERVER_CONNS,
+  NODE_COUNTER_NET_BYTES_SENT,
+  NODE_COUNTER_NET_BYTES_RECV,
+  NODE_COUNTER_GC_PERCENTTIME,
+  NODE_COUNTER_PIPE_BYTES_SENT,
+  NODE_COUNTER_PIPE_BYTES_RECV,
+  NODE_COUNTER_MAX
+};
+
+struct NodeCounterSegment {
+  uint32_t magic;    // kNodeCounterMagic
+  uint32_t version;  // kNodeCounterVersion
+  uint32_t pid;
+  uint32_t count;    // Number of counters that follow.
+  uint64_t counters[NODE_COUNTER_MAX];
+};
+
+static const uint32_t kNodeCounterMagic = 0x6e6f6463;  // "nodc"
+static const uint32_t kNodeCounterVersion = 1;
+
+extern NodeCounterSegment* node_counter_segment;
+
+inline bool NODE_COUNTER_ENABLED() { return node_counter_segment != NULL; }
+
+inline void NODE_COUNTER_ADD(NodeCounter counter, int64_t value) {
+  if (node_counter_segment != NULL)
+    node_counter_segment->counters[counter] += value;
+}
+
+inline void NODE_COUNT_HTTP_SERVER_REQUEST() {
+  NODE_COUNTER_ADD(NODE_COUNTER_HTTP_SERVER_REQUEST, 1);
+}
+
+inline void NODE_COUNT_HTTP_SERVER_RESPONSE() {
+  NODE_COUNTER_ADD(NODE_COUNTER_HTTP_SERVER_RESPONSE, 1);
+}
+
+inline void NODE_COUNT_HTTP_CLIENT_REQUEST() {
+  NODE_COUNTER_ADD(NODE_COUNTER_HTTP_CLIENT_REQUEST, 1);
+}
+
+inline void NODE_COUNT_HTTP_CLIENT_RESPONSE() {
+  NODE_COUNTER_ADD(NODE_COUNTER_HTTP_CLIENT_RESPONSE, 1);
+}
+
+inline void NODE_COUNT_SERVER_CONN_OPEN() {
+  NODE_COUNTER_ADD(NODE_COUNTER_SERVER_CONNS, 1);
+}
+
+inline void NODE_COUNT_SERVER_CONN_CLOSE() {
+  NODE_COUNTER_ADD(NODE_COUNTER_SERVER_CONNS, -1);
+}
+
+inline void NODE_COUNT_NET_BYTES_SENT(int bytes) {
+  NODE_COUNTER_ADD(NODE_COUNTER_NET_BYTES_SENT, bytes);
+}
+
+inline void NODE_COUNT_NET_BYTES_RECV(int bytes) {
+  NODE_COUNTER_ADD(NODE_COUNTER_NET_BYTES_RECV, bytes);
+}
+
+inline void NODE_COUNT_PIPE_BYTES_SENT(int bytes) {
+  NODE_COUNTER_ADD(NODE_COUNTER_PIPE_BYTES_SENT, bytes);
+}
+
+inline void NODE_COUNT_PIPE_BYTES_RECV(int bytes) {
+  NODE_COUNTER_ADD(NODE_COUNTER_PIPE_BYTES_RECV, bytes);
+}
+
+inline void NODE_COUNT_GC_PERCENTTIME(unsigned int percent) {
+  if (node_counter_segment != NULL)
+    node_counter_segment->counters[NODE_COUNTER_GC_PERCENTTIME] = percent;
+}
+
+uint64_t NODE_COUNT_GET_GC_RAWTIME();
+
+void InitPerfCountersLinux();
+void TermPerfCountersLinux();
+
+}  // namespace node
+
+#endif  // SRC_NODE_LINUX_PERFCTR_PROVIDER_H_
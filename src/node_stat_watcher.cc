@@ -31,6 +31,17 @@
 #include <string.h>
 #include <stdlib.h>
 
+#if defined(__linux__)
+#include "queue.h"
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+#endif
+
 namespace node {
 
 using v8::Context;
@@ -66,9 +77,579 @@ static void Delete(uv_handle_t* handle) {
 }
 
 
+#if defined(__linux__)
+// Watching a file with uv_fs_poll costs a stat() on the threadpool every
+// interval, which adds up quickly with thousands of watched files.  On Linux
+// the directory that holds the file is watched with inotify instead and the
+// file is only stat()ed after the directory reported an event for it.  The
+// stat results are compared the way uv_fs_poll does, so the listener sees
+// the same curr/prev pairs, just without the polling delay.
+class InotifyStatRegistry {
+ public:
+  static InotifyStatRegistry* Get(uv_loop_t* loop);
+
+  int Watch(const char* dir, unsigned int interval, QUEUE* member);
+  void Unwatch(int wd, QUEUE* member);
+  void Ref();
+  void Unref();
+
+ private:
+  static const uint32_t kMask = IN_ATTRIB | IN_CREATE | IN_MODIFY |
+                                IN_DELETE | IN_DELETE_SELF | IN_MOVE_SELF |
+                                IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+  // The watchers of the files in one watched directory.  inotify doesn't
+  // tell when a parent of the directory is renamed or a symlink on the way
+  // to it is pointed elsewhere, so every |interval| milliseconds |timer|
+  // checks that |path| still leads to the watched directory.
+  struct Dir {
+    QUEUE watchers;
+    int wd;
+    char* path;
+    dev_t dev;
+    ino_t ino;
+    unsigned int interval;  // The shortest interval of the watchers.
+    uv_timer_t timer;
+  };
+
+  InotifyStatRegistry(uv_loop_t* loop, int fd);
+
+  static void OnReadable(uv_poll_t* handle, int status, int events);
+  static void OnDirTimer(uv_timer_t* handle);
+  static void OnDirClose(uv_handle_t* handle);
+  void OnEvent(const struct inotify_event* e);
+  void Forget(int wd);
+  void Delete(Dir* dir);
+
+  static InotifyStatRegistry* instance_;
+
+  uv_loop_t* const loop_;
+  const int fd_;
+  uv_poll_t poll_;
+  unsigned int refs_;
+  Dir** dirs_;  // Indexed by watch descriptor.
+  size_t dirs_size_;
+};
+
+
+// Watches one file for a StatWatcher.  The file is stat()ed at most once per
+// |interval| milliseconds: right away for the first event after a quiet
+// interval, at the end of the interval for events that arrive within it.
+// While its directory can't be watched, for example because it doesn't exist
+// (yet), the file is stat()ed every |interval| milliseconds and the directory
+// watch is retried.
+class InotifyStatWatcher {
+ public:
+  static InotifyStatWatcher* New(StatWatcher* owner,
+                                 const char* path,
+                                 unsigned int interval,
+                                 bool persistent);
+
+  void Stop();
+  void Changed();
+  void Lost();
+
+  inline const char* name() const { return name_; }
+  inline unsigned int interval() const { return interval_; }
+
+  QUEUE member_;
+
+ private:
+  InotifyStatWatcher(StatWatcher* owner,
+                     InotifyStatRegistry* registry,
+                     const char* path,
+                     unsigned int interval,
+                     bool persistent);
+  ~InotifyStatWatcher();
+
+  void WatchDir();
+  void Stat();
+  static void OnStat(uv_fs_t* req);
+  static void OnTimer(uv_timer_t* handle);
+  static void OnTimerClose(uv_handle_t* handle);
+
+  StatWatcher* owner_;
+  InotifyStatRegistry* const registry_;
+  char* const path_;
+  char* dir_;
+  const char* name_;
+  const unsigned int interval_;
+  const bool persistent_;
+  int wd_;
+  uv_timer_t* timer_;
+  uv_fs_t req_;
+  bool busy_;
+  bool dirty_;
+  // Like uv_fs_poll: 0 before the first stat(), 1 after a successful one,
+  // the error code after a failed one.
+  int status_;
+  uv_stat_t statbuf_;
+};
+
+
+// File systems where other machines can change files without the kernel
+// knowing, or that don't report changes at all.
+static bool IsInotifyCapable(const struct statfs* s) {
+  switch (static_cast<uint32_t>(s->f_type)) {
+    case 0x6969:      // NFS
+    case 0x517B:      // SMB
+    case 0xFF534D42:  // CIFS
+    case 0xFE534D42:  // SMB2
+    case 0x65735546:  // FUSE
+    case 0x01021997:  // 9P
+    case 0x73757245:  // Coda
+    case 0x5346414F:  // AFS
+    case 0x00C36400:  // Ceph
+    case 0x9FA0:      // proc
+    case 0x62656572:  // sysfs
+      return false;
+  }
+  return true;
+}
+
+
+static bool StatEqual(const uv_stat_t* a, const uv_stat_t* b) {
+  return a->st_ctim.tv_nsec == b->st_ctim.tv_nsec &&
+         a->st_mtim.tv_nsec == b->st_mtim.tv_nsec &&
+         a->st_birthtim.tv_nsec == b->st_birthtim.tv_nsec &&
+         a->st_ctim.tv_sec == b->st_ctim.tv_sec &&
+         a->st_mtim.tv_sec == b->st_mtim.tv_sec &&
+         a->st_birthtim.tv_sec == b->st_birthtim.tv_sec &&
+         a->st_size == b->st_size &&
+         a->st_mode == b->st_mode &&
+         a->st_uid == b->st_uid &&
+         a->st_gid == b->st_gid &&
+         a->st_ino == b->st_ino &&
+         a->st_dev == b->st_dev &&
+         a->st_flags == b->st_flags &&
+         a->st_gen == b->st_gen;
+}
+
+
+InotifyStatRegistry* InotifyStatRegistry::instance_;
+
+
+// There is one inotify instance for all StatWatchers.  Returns NULL when
+// inotify isn't available.
+InotifyStatRegistry* InotifyStatRegistry::Get(uv_loop_t* loop) {
+  if (instance_ == NULL) {
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd == -1)
+      return NULL;
+    instance_ = new InotifyStatRegistry(loop, fd);
+  }
+  return instance_->loop_ == loop ? instance_ : NULL;
+}
+
+
+InotifyStatRegistry::InotifyStatRegistry(uv_loop_t* loop, int fd)
+    : loop_(loop),
+      fd_(fd),
+      refs_(0),
+      dirs_(NULL),
+      dirs_size_(0) {
+  CHECK_EQ(0, uv_poll_init(loop, &poll_, fd));
+  CHECK_EQ(0, uv_poll_start(&poll_, UV_READABLE, OnReadable));
+  uv_unref(reinterpret_cast<uv_handle_t*>(&poll_));
+  poll_.data = this;
+}
+
+
+// Returns the watch descriptor of |dir| or an error code.
+int InotifyStatRegistry::Watch(const char* dir,
+                               unsigned int interval,
+                               QUEUE* member) {
+  int wd = inotify_add_watch(fd_, dir, kMask);
+  if (wd == -1)
+    return -errno;
+
+  if (static_cast<size_t>(wd) >= dirs_size_) {
+    size_t size = dirs_size_ * 2;
+    if (size <= static_cast<size_t>(wd))
+      size = wd + 1;
+    dirs_ = static_cast<Dir**>(realloc(dirs_, size * sizeof(*dirs_)));
+    if (dirs_ == NULL)
+      FatalError("node::InotifyStatRegistry::Watch()", "Out Of Memory");
+    memset(dirs_ + dirs_size_, 0, (size - dirs_size_) * sizeof(*dirs_));
+    dirs_size_ = size;
+  }
+
+  // Watchers of files in the same directory share its watch descriptor.
+  Dir* d = dirs_[wd];
+  if (d == NULL) {
+    struct stat s;
+    if (stat(dir, &s) != 0) {
+      int err = -errno;
+      inotify_rm_watch(fd_, wd);
+      return err;
+    }
+    d = new Dir;
+    QUEUE_INIT(&d->watchers);
+    d->wd = wd;
+    d->path = strdup(dir);
+    d->dev = s.st_dev;
+    d->ino = s.st_ino;
+    d->interval = interval;
+    CHECK_EQ(0, uv_timer_init(loop_, &d->timer));
+    uv_unref(reinterpret_cast<uv_handle_t*>(&d->timer));
+    uv_timer_start(&d->timer, OnDirTimer, interval, 0);
+    dirs_[wd] = d;
+  } else if (interval < d->interval) {
+    d->interval = interval;
+    uv_timer_start(&d->timer, OnDirTimer, interval, 0);
+  }
+  QUEUE_INSERT_TAIL(&d->watchers, member);
+  return wd;
+}
+
+
+void InotifyStatRegistry::Unwatch(int wd, QUEUE* member) {
+  Dir* d = dirs_[wd];
+  QUEUE_REMOVE(member);
+  QUEUE_INIT(member);
+
+  if (QUEUE_EMPTY(&d->watchers)) {
+    inotify_rm_watch(fd_, wd);
+    dirs_[wd] = NULL;
+    return Delete(d);
+  }
+
+  // Takes effect when the timer fires next.
+  QUEUE* q;
+  d->interval = UINT_MAX;
+  QUEUE_FOREACH(q, &d->watchers) {
+    unsigned int interval =
+        QUEUE_DATA(q, InotifyStatWatcher, member_)->interval();
+    if (interval < d->interval)
+      d->interval = interval;
+  }
+}
+
+
+void InotifyStatRegistry::Delete(Dir* dir) {
+  free(dir->path);
+  dir->path = NULL;
+  uv_close(reinterpret_cast<uv_handle_t*>(&dir->timer), OnDirClose);
+}
+
+
+void InotifyStatRegistry::OnDirClose(uv_handle_t* handle) {
+  Dir* d = ContainerOf(&Dir::timer, reinterpret_cast<uv_timer_t*>(handle));
+  delete d;
+}
+
+
+// Checks that the directory's path still leads to it.  One stat() per
+// directory, however many files in it are watched.
+void InotifyStatRegistry::OnDirTimer(uv_timer_t* handle) {
+  Dir* d = ContainerOf(&Dir::timer, handle);
+  struct stat s;
+  if (stat(d->path, &s) == 0 && s.st_dev == d->dev && s.st_ino == d->ino) {
+    uv_timer_start(handle, OnDirTimer, d->interval, 0);
+    return;
+  }
+
+  // A parent directory was renamed or replaced, the path leads somewhere
+  // else now.  The watchers poll until they can watch the new directory.
+  inotify_rm_watch(instance_->fd_, d->wd);
+  instance_->Forget(d->wd);
+}
+
+
+// Persistent watchers keep the event loop alive.
+void InotifyStatRegistry::Ref() {
+  if (refs_++ == 0)
+    uv_ref(reinterpret_cast<uv_handle_t*>(&poll_));
+}
+
+
+void InotifyStatRegistry::Unref() {
+  if (--refs_ == 0)
+    uv_unref(reinterpret_cast<uv_handle_t*>(&poll_));
+}
+
+
+void InotifyStatRegistry::OnReadable(uv_poll_t* handle,
+                                     int status,
+                                     int events) {
+  InotifyStatRegistry* registry =
+      static_cast<InotifyStatRegistry*>(handle->data);
+  char buf[4096]
+      __attribute__((aligned(__alignof__(struct inotify_event))));
+
+  for (;;) {
+    ssize_t size;
+    do {
+      size = read(registry->fd_, buf, sizeof(buf));
+    } while (size == -1 && errno == EINTR);
+
+    if (size == -1) {
+      CHECK(errno == EAGAIN || errno == EWOULDBLOCK);
+      break;
+    }
+
+    for (const char* p = buf; p < buf + size; ) {
+      const struct inotify_event* e =
+          reinterpret_cast<const struct inotify_event*>(p);
+      registry->OnEvent(e);
+      p += sizeof(*e) + e->len;
+    }
+  }
+}
+
+
+// Only starts stat() calls, none of this calls into JS.
+void InotifyStatRegistry::OnEvent(const struct inotify_event* e) {
+  QUEUE* q;
+
+  // Events were dropped, check every file.
+  if (e->mask & IN_Q_OVERFLOW) {
+    for (size_t wd = 0; wd < dirs_size_; wd += 1) {
+      if (dirs_[wd] == NULL)
+        continue;
+      QUEUE_FOREACH(q, &dirs_[wd]->watchers) {
+        QUEUE_DATA(q, InotifyStatWatcher, member_)->Changed();
+      }
+    }
+    return;
+  }
+
+  if (e->wd < 0 ||
+      static_cast<size_t>(e->wd) >= dirs_size_ ||
+      dirs_[e->wd] == NULL) {
+    return;  // Stale event for a watch that was removed.
+  }
+
+  // The directory is gone or isn't at the same path anymore.
+  if (e->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF | IN_UNMOUNT)) {
+    if (!(e->mask & IN_IGNORED))
+      inotify_rm_watch(fd_, e->wd);
+    return Forget(e->wd);
+  }
+
+  if (e->len == 0)
+    return;
+
+  QUEUE_FOREACH(q, &dirs_[e->wd]->watchers) {
+    InotifyStatWatcher* watcher = QUEUE_DATA(q, InotifyStatWatcher, member_);
+    if (strcmp(watcher->name(), e->name) == 0)
+      watcher->Changed();
+  }
+}
+
+
+void InotifyStatRegistry::Forget(int wd) {
+  Dir* dir = dirs_[wd];
+  dirs_[wd] = NULL;
+
+  while (!QUEUE_EMPTY(&dir->watchers)) {
+    QUEUE* q = QUEUE_HEAD(&dir->watchers);
+    QUEUE_REMOVE(q);
+    QUEUE_INIT(q);
+    QUEUE_DATA(q, InotifyStatWatcher, member_)->Lost();
+  }
+
+  Delete(dir);
+}
+
+
+// Returns true when |path| doesn't go through symlinks, which can be pointed
+// somewhere else without inotify noticing.
+static bool IsRealPath(const char* path) {
+  char* real = realpath(path, NULL);
+  if (real == NULL)
+    return false;
+  bool same = strcmp(real, path) == 0;
+  free(real);
+  return same;
+}
+
+
+// Returns NULL when the file should be polled with uv_fs_poll instead:
+// inotify doesn't see changes to the target of a symlink, nor changes that
+// are made on other machines.
+InotifyStatWatcher* InotifyStatWatcher::New(StatWatcher* owner,
+                                            const char* path,
+                                            unsigned int interval,
+                                            bool persistent) {
+  if (path[0] != '/' || interval == 0)
+    return NULL;
+
+  struct stat s;
+  if (lstat(path, &s) == 0 && S_ISLNK(s.st_mode))
+    return NULL;
+
+  InotifyStatRegistry* registry =
+      InotifyStatRegistry::Get(owner->env()->event_loop());
+  if (registry == NULL)
+    return NULL;
+
+  InotifyStatWatcher* watcher =
+      new InotifyStatWatcher(owner, registry, path, interval, persistent);
+
+  struct statfs fs;
+  if (statfs(watcher->dir_, &fs) == 0 &&
+      (!IsInotifyCapable(&fs) || !IsRealPath(watcher->dir_))) {
+    watcher->Stop();
+    return NULL;
+  }
+  watcher->WatchDir();
+
+  // Take the first stat() that later ones are compared to.
+  watcher->Stat();
+  return watcher;
+}
+
+
+InotifyStatWatcher::InotifyStatWatcher(StatWatcher* owner,
+                                       InotifyStatRegistry* registry,
+                                       const char* path,
+                                       unsigned int interval,
+                                       bool persistent)
+    : owner_(owner),
+      registry_(registry),
+      path_(strdup(path)),
+      interval_(interval),
+      persistent_(persistent),
+      wd_(-1),
+      timer_(new uv_timer_t),
+      busy_(false),
+      dirty_(false),
+      status_(0) {
+  QUEUE_INIT(&member_);
+  memset(&statbuf_, 0, sizeof(statbuf_));
+
+  // "/a/b" is watched as "b" in "/a", "/a" as "a" in "/".
+  char* slash = strrchr(path_, '/');
+  name_ = slash + 1;
+  dir_ = slash == path_ ? strdup("/") : strndup(path_, slash - path_);
+
+  uv_timer_init(owner->env()->event_loop(), timer_);
+  timer_->data = this;
+  if (persistent_)
+    registry_->Ref();
+  else
+    uv_unref(reinterpret_cast<uv_handle_t*>(timer_));
+}
+
+
+InotifyStatWatcher::~InotifyStatWatcher() {
+  free(path_);
+  free(dir_);
+}
+
+
+// Detaches from the StatWatcher.  Deletes itself once no stat() is running.
+void InotifyStatWatcher::Stop() {
+  owner_ = NULL;
+  if (wd_ >= 0)
+    registry_->Unwatch(wd_, &member_);
+  wd_ = -1;
+  if (persistent_)
+    registry_->Unref();
+  uv_close(reinterpret_cast<uv_handle_t*>(timer_), OnTimerClose);
+  timer_ = NULL;
+  if (!busy_)
+    delete this;
+}
+
+
+// Stats right away when the file was quiet for an interval, otherwise
+// OnTimer() picks the change up at the end of the interval.
+void InotifyStatWatcher::Changed() {
+  dirty_ = true;
+  if (!busy_ && !uv_is_active(reinterpret_cast<uv_handle_t*>(timer_)))
+    Stat();
+}
+
+
+// The directory isn't watched anymore, poll until it can be watched again.
+void InotifyStatWatcher::Lost() {
+  wd_ = -1;
+  Changed();
+}
+
+
+// Watches the directory if it exists by now.  One that is reached through a
+// symlink is left to polling, like in New().
+void InotifyStatWatcher::WatchDir() {
+  struct statfs fs;
+  if (statfs(dir_, &fs) != 0 || !IsInotifyCapable(&fs) || !IsRealPath(dir_))
+    return;
+
+  int wd = registry_->Watch(dir_, interval_, &member_);
+  if (wd >= 0)
+    wd_ = wd;
+}
+
+
+void InotifyStatWatcher::Stat() {
+  busy_ = true;
+  dirty_ = false;
+  CHECK_EQ(0, uv_fs_stat(owner_->env()->event_loop(), &req_, path_, OnStat));
+}
+
+
+void InotifyStatWatcher::OnStat(uv_fs_t* req) {
+  InotifyStatWatcher* watcher = ContainerOf(&InotifyStatWatcher::req_, req);
+  watcher->busy_ = false;
+
+  if (watcher->owner_ == NULL) {
+    uv_fs_req_cleanup(req);
+    delete watcher;
+    return;
+  }
+
+  const int status = req->result;
+  const uv_stat_t prev = watcher->statbuf_;
+  uv_stat_t curr;
+  memset(&curr, 0, sizeof(curr));
+  bool report = false;
+
+  if (status != 0) {
+    report = watcher->status_ != status;
+    watcher->status_ = status;
+  } else {
+    curr = req->statbuf;
+    report = watcher->status_ < 0 ||
+             (watcher->status_ != 0 && !StatEqual(&prev, &curr));
+    watcher->statbuf_ = curr;
+    watcher->status_ = 1;
+  }
+  uv_fs_req_cleanup(req);
+
+  // Starts the interval in which events only mark the file dirty.
+  uv_timer_start(watcher->timer_, OnTimer, watcher->interval_, 0);
+
+  // Last, the listener can stop the watcher.
+  if (report)
+    watcher->owner_->Report(status, &prev, &curr);
+}
+
+
+void InotifyStatWatcher::OnTimer(uv_timer_t* handle) {
+  InotifyStatWatcher* watcher = static_cast<InotifyStatWatcher*>(handle->data);
+  if (watcher->wd_ < 0) {
+    watcher->WatchDir();
+    watcher->Stat();
+  } else if (watcher->dirty_) {
+    watcher->Stat();
+  }
+}
+
+
+void InotifyStatWatcher::OnTimerClose(uv_handle_t* handle) {
+  delete reinterpret_cast<uv_timer_t*>(handle);
+}
+#endif  // defined(__linux__)
+
+
 StatWatcher::StatWatcher(Environment* env, Local<Object> wrap)
     : AsyncWrap(env, wrap, AsyncWrap::PROVIDER_STATWATCHER),
       watcher_(new uv_fs_poll_t) {
+#if defined(__linux__)
+  inotify_ = NULL;
+#endif
   MakeWeak<StatWatcher>(this);
   uv_fs_poll_init(env->event_loop(), watcher_);
   watcher_->data = static_cast<void*>(this);
@@ -87,7 +668,14 @@ void StatWatcher::Callback(uv_fs_poll_t* handle,
                            const uv_stat_t* curr) {
   StatWatcher* wrap = static_cast<StatWatcher*>(handle->data);
   assert(wrap->watcher_ == handle);
-  Environment* env = wrap->env();
+  wrap->Report(status, prev, curr);
+}
+
+
+void StatWatcher::Report(int status,
+                         const uv_stat_t* prev,
+                         const uv_stat_t* curr) {
+  Environment* env = this->env();
   HandleScope handle_scope(env->isolate());
   Context::Scope context_scope(env->context());
   Local<Value> argv[] = {
@@ -95,7 +683,7 @@ void StatWatcher::Callback(uv_fs_poll_t* handle,
     BuildStatsObject(env, prev),
     Integer::New(env->isolate(), status)
   };
-  wrap->MakeCallback(env->onchange_string(), ARRAY_SIZE(argv), argv);
+  MakeCallback(env->onchange_string(), ARRAY_SIZE(argv), argv);
 }
 
 
@@ -117,6 +705,14 @@ void StatWatcher::Start(const FunctionCallbackInfo<Value>& args) {
   const bool persistent = args[1]->BooleanValue();
   const uint32_t interval = args[2]->Uint32Value();
 
+#if defined(__linux__)
+  wrap->inotify_ = InotifyStatWatcher::New(wrap, *path, interval, persistent);
+  if (wrap->inotify_ != NULL) {
+    wrap->ClearWeak();
+    return;
+  }
+#endif
+
   if (!persistent)
     uv_unref(reinterpret_cast<uv_handle_t*>(wrap->watcher_));
   uv_fs_poll_start(wrap->watcher_, Callback, *path, interval);
@@ -135,6 +731,14 @@ void StatWatcher::Stop(const FunctionCallbackInfo<Value>& args) {
 
 
 void StatWatcher::Stop() {
+#if defined(__linux__)
+  if (inotify_ != NULL) {
+    inotify_->Stop();
+    inotify_ = NULL;
+    MakeWeak<StatWatcher>(this);
+    return;
+  }
+#endif
   if (!uv_is_active(reinterpret_cast<uv_handle_t*>(watcher_)))
     return;
   uv_fs_poll_stop(watcher_);
@@ -30,6 +30,10 @@
 
 namespace node {
 
+#if defined(__linux__)
+class InotifyStatWatcher;
+#endif
+
 class StatWatcher : public AsyncWrap {
  public:
   virtual ~StatWatcher();
@@ -48,9 +52,15 @@ class StatWatcher : public AsyncWrap {
                        int status,
                        const uv_stat_t* prev,
                        const uv_stat_t* curr);
+  void Report(int status, const uv_stat_t* prev, const uv_stat_t* curr);
   void Stop();
 
   uv_fs_poll_t* watcher_;
+#if defined(__linux__)
+  // Watches the file with inotify instead of watcher_ when that works.
+  friend class InotifyStatWatcher;
+  InotifyStatWatcher* inotify_;
+#endif
 };
 
 }  // namespace node
@@ -36,6 +36,7 @@ using v8::GCType;
 using v8::Handle;
 using v8::HandleScope;
 using v8::HeapStatistics;
+using v8::Integer;
 using v8::Isolate;
 using v8::Local;
 using v8::Null;
@@ -43,6 +44,7 @@ using v8::Number;
 using v8::Object;
 using v8::Uint32;
 using v8::Value;
+using v8::kExternalFloat64Array;
 using v8::kGCTypeAll;
 using v8::kGCTypeMarkSweepCompact;
 using v8::kGCTypeScavenge;
@@ -72,10 +74,18 @@ void Environment::IsolateData::AfterGarbageCollection(GCType type,
                                                       GCCallbackFlags flags) {
   gc_info_after_ = GCInfo(isolate(), type, flags, uv_hrtime());
 
+  if (gc_stats_.enabled()) {
+    gc_stats_.Record(type,
+                     gc_info_after_.timestamp() - gc_info_before_.timestamp(),
+                     gc_info_before_.stats()->used_heap_size(),
+                     gc_info_after_.stats()->used_heap_size());
+  }
+
   // The copy upfront and the remove-then-insert is to avoid corrupting the
   // list when the callback removes itself from it.  QUEUE_FOREACH() is unsafe
   // when the list is mutated while being walked.
-  ASSERT(QUEUE_EMPTY(&gc_tracker_queue_) == false);
+  if (QUEUE_EMPTY(&gc_tracker_queue_))
+    return;
   QUEUE queue;
   QUEUE* q = QUEUE_HEAD(&gc_tracker_queue_);
   QUEUE_SPLIT(&gc_tracker_queue_, q, &queue);
@@ -89,14 +99,52 @@ void Environment::IsolateData::AfterGarbageCollection(GCType type,
 }
 
 
-void Environment::IsolateData::StartGarbageCollectionTracking(
-    Environment* env) {
-  if (QUEUE_EMPTY(&gc_tracker_queue_)) {
+void Environment::GCStats::Record(GCType type,
+                                  uint64_t pause,
+                                  size_t used_before,
+                                  size_t used_after) {
+  double* fields = fields_;
+  if (type == kGCTypeMarkSweepCompact)
+    fields += kMarkSweepCompact * kFieldsPerType;
+  else
+    fields += kScavenge * kFieldsPerType;
+
+  double ms = pause / 1e6;
+  fields[kCount] += 1;
+  fields[kPauseTotal] += ms;
+  if (ms > fields[kPauseMax])
+    fields[kPauseMax] = ms;
+  // Objects promoted or allocated during the GC can make the heap grow.
+  if (used_before > used_after)
+    fields[kReclaimed] += used_before - used_after;
+  // In microseconds, bucket 0 is < 1 us.
+  fields[kPause + Log2Bucket(pause / 1000, kPauseBuckets)] += 1;
+}
+
+
+// The GC callbacks are installed for as long as there is at least one
+// 'gc' event listener or the GC stats are enabled.
+void Environment::IsolateData::UpdateGarbageCollectionCallbacks() {
+  bool wants_gc_callbacks =
+      gc_stats_.enabled() || QUEUE_EMPTY(&gc_tracker_queue_) == false;
+  if (wants_gc_callbacks == has_gc_callbacks_)
+    return;
+  if (wants_gc_callbacks) {
     isolate()->AddGCPrologueCallback(BeforeGarbageCollection, v8::kGCTypeAll);
     isolate()->AddGCEpilogueCallback(AfterGarbageCollection, v8::kGCTypeAll);
+  } else {
+    isolate()->RemoveGCPrologueCallback(BeforeGarbageCollection);
+    isolate()->RemoveGCEpilogueCallback(AfterGarbageCollection);
   }
+  has_gc_callbacks_ = wants_gc_callbacks;
+}
+
+
+void Environment::IsolateData::StartGarbageCollectionTracking(
+    Environment* env) {
   ASSERT(QUEUE_EMPTY(&env->gc_tracker_queue_) == true);
   QUEUE_INSERT_TAIL(&gc_tracker_queue_, &env->gc_tracker_queue_);
+  UpdateGarbageCollectionCallbacks();
 }
 
 
@@ -104,10 +152,19 @@ void Environment::IsolateData::StopGarbageCollectionTracking(Environment* env) {
   ASSERT(QUEUE_EMPTY(&env->gc_tracker_queue_) == false);
   QUEUE_REMOVE(&env->gc_tracker_queue_);
   QUEUE_INIT(&env->gc_tracker_queue_);
-  if (QUEUE_EMPTY(&gc_tracker_queue_)) {
-    isolate()->RemoveGCPrologueCallback(BeforeGarbageCollection);
-    isolate()->RemoveGCEpilogueCallback(AfterGarbageCollection);
-  }
+  UpdateGarbageCollectionCallbacks();
+}
+
+
+void Environment::IsolateData::StartGarbageCollectionStats() {
+  gc_stats_.set_enabled(true);
+  UpdateGarbageCollectionCallbacks();
+}
+
+
+void Environment::IsolateData::StopGarbageCollectionStats() {
+  gc_stats_.set_enabled(false);
+  UpdateGarbageCollectionCallbacks();
 }
 
 
@@ -171,6 +228,16 @@ void Environment::StopGarbageCollectionTracking() {
 }
 
 
+void Environment::StartGarbageCollectionStats() {
+  isolate_data()->StartGarbageCollectionStats();
+}
+
+
+void Environment::StopGarbageCollectionStats() {
+  isolate_data()->StopGarbageCollectionStats();
+}
+
+
 void StartGarbageCollectionTracking(const FunctionCallbackInfo<Value>& args) {
   CHECK(args[0]->IsFunction() == true);
   HandleScope handle_scope(args.GetIsolate());
@@ -207,9 +274,43 @@ void StopGarbageCollectionTracking(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+void StartGarbageCollectionStats(const FunctionCallbackInfo<Value>& args) {
+  Environment::GetCurrent(args.GetIsolate())->StartGarbageCollectionStats();
+}
+
+
+void StopGarbageCollectionStats(const FunctionCallbackInfo<Value>& args) {
+  Environment::GetCurrent(args.GetIsolate())->StopGarbageCollectionStats();
+}
+
+
 void InitializeV8Bindings(Handle<Object> target,
                           Handle<Value> unused,
                           Handle<Context> context) {
+  Environment* env = Environment::GetCurrent(context);
+  Environment::GCStats* gc_stats = env->gc_stats();
+
+  // GC type n occupies fields [n * kGCFieldsPerType,
+  // (n + 1) * kGCFieldsPerType) of the gcStats array.
+  Local<Object> fields = Object::New(env->isolate());
+  fields->SetIndexedPropertiesToExternalArrayData(gc_stats->fields(),
+                                                  kExternalFloat64Array,
+                                                  gc_stats->fields_count());
+  target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "gcStats"), fields);
+#define V(name, value)                                                        \
+  target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), name),                    \
+              Integer::New(env->isolate(), Environment::GCStats::value));
+  V("kGCScavenge", kScavenge)
+  V("kGCMarkSweepCompact", kMarkSweepCompact)
+  V("kGCCount", kCount)
+  V("kGCPauseTotal", kPauseTotal)
+  V("kGCPauseMax", kPauseMax)
+  V("kGCReclaimed", kReclaimed)
+  V("kGCPause", kPause)
+  V("kGCPauseBuckets", kPauseBuckets)
+  V("kGCFieldsPerType", kFieldsPerType)
+#undef V
+
   NODE_SET_METHOD(target,
                   "startGarbageCollectionTracking",
                   StartGarbageCollectionTracking);
@@ -217,6 +318,12 @@ void InitializeV8Bindings(Handle<Object> target,
                   "stopGarbageCollectionTracking",
                   StopGarbageCollectionTracking);
   NODE_SET_METHOD(target, "getHeapStatistics", GetHeapStatistics);
+  NODE_SET_METHOD(target,
+                  "startGarbageCollectionStats",
+                  StartGarbageCollectionStats);
+  NODE_SET_METHOD(target,
+                  "stopGarbageCollectionStats",
+                  StopGarbageCollectionStats);
 }
 
 }  // namespace node
@@ -29,26 +29,31 @@ namespace node {
 
 using v8::V8;
 
-
-Watchdog::Watchdog(Environment* env, uint64_t ms) : env_(env),
-                                                    destroyed_(false) {
-  int rc;
-  loop_ = new uv_loop_t;
-  CHECK(loop_);
-  rc = uv_loop_init(loop_);
-  CHECK_EQ(0, rc);
-
-  rc = uv_async_init(loop_, &async_, &Watchdog::Async);
-  CHECK_EQ(0, rc);
-
-  rc = uv_timer_init(loop_, &timer_);
-  CHECK_EQ(0, rc);
-
-  rc = uv_timer_start(&timer_, &Watchdog::Timer, ms, 0);
-  CHECK_EQ(0, rc);
-
-  rc = uv_thread_create(&thread_, &Watchdog::Run, this);
-  CHECK_EQ(0, rc);
+// State shared by all Watchdogs, guarded by |mutex|.  |heap| is a binary
+// min-heap ordered by deadline.
+static const size_t kNotQueued = static_cast<size_t>(-1);
+static uv_once_t init_once = UV_ONCE_INIT;
+static uv_mutex_t mutex;
+static uv_cond_t cond;
+static uv_thread_t thread;
+static Watchdog** heap;
+static size_t heap_size;
+static size_t heap_capacity;
+
+
+Watchdog::Watchdog(Environment* env, uint64_t ms)
+    : env_(env),
+      isolate_(env->isolate()),
+      deadline_(uv_hrtime() + ms * 1000000),
+      heap_index_(kNotQueued),
+      destroyed_(false) {
+  uv_once(&init_once, Init);
+  uv_mutex_lock(&mutex);
+  HeapPush(this);
+  // Wake up the thread if this is the new earliest deadline.
+  if (heap_index_ == 0)
+    uv_cond_signal(&cond);
+  uv_mutex_unlock(&mutex);
 }
 
 
@@ -67,42 +72,109 @@ void Watchdog::Destroy() {
     return;
   }
 
-  uv_async_send(&async_);
-  uv_thread_join(&thread_);
-
-  uv_close(reinterpret_cast<uv_handle_t*>(&async_), NULL);
+  // No need to wake up the thread, it'll find that the heap has changed
+  // when its current wait times out.
+  uv_mutex_lock(&mutex);
+  if (heap_index_ != kNotQueued)
+    HeapRemove(this);
+  uv_mutex_unlock(&mutex);
 
-  // UV_RUN_DEFAULT so that libuv has a chance to clean up.
-  uv_run(loop_, UV_RUN_DEFAULT);
+  destroyed_ = true;
+}
 
-  int rc = uv_loop_close(loop_);
-  CHECK_EQ(0, rc);
-  delete loop_;
-  loop_ = NULL;
 
-  destroyed_ = true;
+void Watchdog::Init() {
+  CHECK_EQ(0, uv_mutex_init(&mutex));
+  CHECK_EQ(0, uv_cond_init(&cond));
+  CHECK_EQ(0, uv_thread_create(&thread, Run, NULL));
 }
 
 
 void Watchdog::Run(void* arg) {
-  Watchdog* wd = static_cast<Watchdog*>(arg);
+  uv_mutex_lock(&mutex);
+
+  for (;;) {
+    if (heap_size == 0) {
+      uv_cond_wait(&cond, &mutex);
+      continue;
+    }
+
+    Watchdog* w = heap[0];
+    uint64_t now = uv_hrtime();
+    if (w->deadline_ > now) {
+      uv_cond_timedwait(&cond, &mutex, w->deadline_ - now);
+      continue;
+    }
+
+    // Holding |mutex| keeps the Watchdog and hence its isolate alive.
+    HeapRemove(w);
+    V8::TerminateExecution(w->isolate_);
+  }
+}
 
-  // UV_RUN_ONCE so async_ or timer_ wakeup exits uv_run() call.
-  uv_run(wd->loop_, UV_RUN_ONCE);
 
-  // Loop ref count reaches zero when both handles are closed.
-  // Close the timer handle on this side and let Destroy() close async_
-  uv_close(reinterpret_cast<uv_handle_t*>(&wd->timer_), NULL);
+void Watchdog::HeapSet(size_t index, Watchdog* w) {
+  heap[index] = w;
+  w->heap_index_ = index;
 }
 
 
-void Watchdog::Async(uv_async_t* async) {
+void Watchdog::HeapPush(Watchdog* w) {
+  if (heap_size == heap_capacity) {
+    heap_capacity = heap_capacity == 0 ? 16 : 2 * heap_capacity;
+    heap = static_cast<Watchdog**>(realloc(heap,
+                                           heap_capacity * sizeof(*heap)));
+    if (heap == NULL)
+      FatalError("node::Watchdog::HeapPush()", "Out Of Memory");
+  }
+  HeapSet(heap_size, w);
+  heap_size += 1;
+  HeapSiftUp(heap_size - 1);
+}
+
+
+void Watchdog::HeapRemove(Watchdog* w) {
+  const size_t index = w->heap_index_;
+  CHECK_LT(index, heap_size);
+  heap_size -= 1;
+  w->heap_index_ = kNotQueued;
+  if (index == heap_size)
+    return;
+  HeapSet(index, heap[heap_size]);
+  HeapSiftUp(index);
+  HeapSiftDown(heap[index]->heap_index_);
 }
 
 
-void Watchdog::Timer(uv_timer_t* timer) {
-  Watchdog* w = ContainerOf(&Watchdog::timer_, timer);
-  V8::TerminateExecution(w->env()->isolate());
+void Watchdog::HeapSiftUp(size_t index) {
+  Watchdog* w = heap[index];
+  while (index > 0) {
+    const size_t parent = (index - 1) / 2;
+    if (heap[parent]->deadline_ <= w->deadline_)
+      break;
+    HeapSet(index, heap[parent]);
+    index = parent;
+  }
+  HeapSet(index, w);
+}
+
+
+void Watchdog::HeapSiftDown(size_t index) {
+  Watchdog* w = heap[index];
+  for (;;) {
+    size_t child = 2 * index + 1;
+    if (child >= heap_size)
+      break;
+    if (child + 1 < heap_size &&
+        heap[child + 1]->deadline_ < heap[child]->deadline_) {
+      child += 1;
+    }
+    if (w->deadline_ <= heap[child]->deadline_)
+      break;
+    HeapSet(index, heap[child]);
+    index = child;
+  }
+  HeapSet(index, w);
 }
 
 
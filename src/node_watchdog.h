@@ -29,6 +29,10 @@
 
 namespace node {
 
+// Terminates JS execution in |env| after |ms| milliseconds unless the
+// Watchdog is destroyed first.  All Watchdogs share a single thread that
+// is started on first use and waits for the earliest pending deadline, so
+// arming a Watchdog doesn't create any threads or event loops.
 class Watchdog {
  public:
   explicit Watchdog(Environment* env, uint64_t ms);
@@ -41,15 +45,18 @@ class Watchdog {
  private:
   void Destroy();
 
+  static void Init();
   static void Run(void* arg);
-  static void Async(uv_async_t* async);
-  static void Timer(uv_timer_t* timer);
+  static void HeapPush(Watchdog* w);
+  static void HeapRemove(Watchdog* w);
+  static void HeapSiftUp(size_t index);
+  static void HeapSiftDown(size_t index);
+  static inline void HeapSet(size_t index, Watchdog* w);
 
   Environment* env_;
-  uv_thread_t thread_;
-  uv_loop_t* loop_;
-  uv_async_t async_;
-  uv_timer_t timer_;
+  v8::Isolate* isolate_;
+  uint64_t deadline_;  // In uv_hrtime() nanoseconds.
+  size_t heap_index_;
   bool destroyed_;
 };
 
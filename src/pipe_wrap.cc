@@ -104,6 +104,8 @@ void PipeWrap::Initialize(Handle<Object> target,
                             StreamWrap::WriteAsciiString);
   NODE_SET_PROTOTYPE_METHOD(t, "writeUtf8String", StreamWrap::WriteUtf8String);
   NODE_SET_PROTOTYPE_METHOD(t, "writeUcs2String", StreamWrap::WriteUcs2String);
+  NODE_SET_PROTOTYPE_METHOD(t, "writev", StreamWrap::Writev);
+  NODE_SET_PROTOTYPE_METHOD(t, "setFramed", StreamWrap::SetFramed);
 
   NODE_SET_PROTOTYPE_METHOD(t, "bind", Bind);
   NODE_SET_PROTOTYPE_METHOD(t, "listen", Listen);
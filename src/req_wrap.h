@@ -40,7 +40,7 @@ class ReqWrap : public AsyncWrap {
   ReqWrap(Environment* env,
           v8::Handle<v8::Object> object,
           AsyncWrap::ProviderType provider = AsyncWrap::PROVIDER_REQWRAP)
-      : AsyncWrap(env, object, AsyncWrap::PROVIDER_REQWRAP) {
+      : AsyncWrap(env, object, provider) {
     if (env->in_domain())
       object->Set(env->domain_string(), env->domain_array()->Get(0));
 
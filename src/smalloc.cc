@@ -25,9 +25,11 @@
 #include "env-inl.h"
 #include "node.h"
 #include "node_internals.h"
+#include "queue.h"
 #include "v8-profiler.h"
 #include "v8.h"
 
+#include <stdint.h>
 #include <string.h>
 #include <assert.h>
 
@@ -36,6 +38,7 @@
 namespace node {
 namespace smalloc {
 
+using v8::Array;
 using v8::Context;
 using v8::External;
 using v8::ExternalArrayType;
@@ -45,6 +48,7 @@ using v8::HandleScope;
 using v8::HeapProfiler;
 using v8::Isolate;
 using v8::Local;
+using v8::Number;
 using v8::Object;
 using v8::Persistent;
 using v8::RetainedObjectInfo;
@@ -144,6 +148,321 @@ void CallbackInfo::WeakCallback(Isolate* isolate, Local<Object> object) {
 }
 
 
+// Size-classed slab allocator for small Buffers.  Every slab is carved up
+// into chunks of a single power-of-two size and chunks are returned to their
+// slab when the Buffer that uses them is collected, so a long-lived small
+// Buffer only pins its own chunk instead of a whole pool.  Slabs are shared
+// by all contexts and are only ever touched from the main thread.
+class SlabPool {
+ public:
+  static const size_t kMinChunkSize = 16;
+  static const unsigned kNumSizeClasses = 24;
+
+  struct Slab {
+    QUEUE member;
+    char* data;
+    char* free_list;
+    size_t size;
+    unsigned size_class;
+    unsigned chunks;
+    unsigned used;
+  };
+
+  struct SizeClass {
+    QUEUE partial;  // Slabs with at least one free chunk.
+    size_t slabs;
+    size_t chunks;
+    size_t used;
+  };
+
+  static inline void Init();
+  static inline size_t pool_size();
+  static inline void set_pool_size(size_t size);
+  static inline size_t ChunkSize(unsigned size_class);
+  static inline bool IsPoolable(size_t length);
+  static char* Alloc(size_t length, Slab** slab);
+  static void Free(char* data, void* hint);
+  static inline const SizeClass* size_class(unsigned index);
+
+ private:
+  static inline unsigned SizeClassIndex(size_t length);
+  static Slab* NewSlab(unsigned size_class);
+  static void DeleteSlab(Slab* slab);
+
+  static bool initialized_;
+  static size_t pool_size_;
+  static SizeClass size_classes_[kNumSizeClasses];
+};
+
+
+bool SlabPool::initialized_;
+size_t SlabPool::pool_size_ = 8 * 1024;
+SlabPool::SizeClass SlabPool::size_classes_[SlabPool::kNumSizeClasses];
+
+
+void SlabPool::Init() {
+  if (initialized_)
+    return;
+  for (unsigned i = 0; i < kNumSizeClasses; i += 1) {
+    QUEUE_INIT(&size_classes_[i].partial);
+    size_classes_[i].slabs = 0;
+    size_classes_[i].chunks = 0;
+    size_classes_[i].used = 0;
+  }
+  initialized_ = true;
+}
+
+
+size_t SlabPool::pool_size() {
+  return pool_size_;
+}
+
+
+// Only affects slabs that are created from now on.
+void SlabPool::set_pool_size(size_t size) {
+  pool_size_ = size;
+}
+
+
+size_t SlabPool::ChunkSize(unsigned size_class) {
+  return kMinChunkSize << size_class;
+}
+
+
+bool SlabPool::IsPoolable(size_t length) {
+  return length > 0 &&
+         length <= pool_size_ / 2 &&
+         length <= ChunkSize(kNumSizeClasses - 1);
+}
+
+
+unsigned SlabPool::SizeClassIndex(size_t length) {
+  unsigned index = 0;
+  while (ChunkSize(index) < length)
+    index += 1;
+  return index;
+}
+
+
+const SlabPool::SizeClass* SlabPool::size_class(unsigned index) {
+  return &size_classes_[index];
+}
+
+
+SlabPool::Slab* SlabPool::NewSlab(unsigned size_class) {
+  const size_t chunk_size = ChunkSize(size_class);
+  size_t size = pool_size_ / chunk_size * chunk_size;
+  if (size < 2 * chunk_size)
+    size = 2 * chunk_size;
+
+  Slab* slab = new Slab;
+  slab->data = static_cast<char*>(malloc(size));
+  if (slab->data == NULL)
+    FatalError("node::smalloc::SlabPool::NewSlab()", "Out Of Memory");
+  slab->size = size;
+  slab->size_class = size_class;
+  slab->chunks = size / chunk_size;
+  slab->used = 0;
+
+  // Thread the free list through the chunks themselves.
+  slab->free_list = NULL;
+  for (size_t offset = size; offset > 0; offset -= chunk_size) {
+    char* chunk = slab->data + offset - chunk_size;
+    *reinterpret_cast<char**>(chunk) = slab->free_list;
+    slab->free_list = chunk;
+  }
+
+  SizeClass* sc = &size_classes_[size_class];
+  sc->slabs += 1;
+  sc->chunks += slab->chunks;
+  QUEUE_INSERT_TAIL(&sc->partial, &slab->member);
+
+  return slab;
+}
+
+
+void SlabPool::DeleteSlab(Slab* slab) {
+  SizeClass* sc = &size_classes_[slab->size_class];
+  CHECK_EQ(slab->used, 0);
+  QUEUE_REMOVE(&slab->member);
+  sc->slabs -= 1;
+  sc->chunks -= slab->chunks;
+  free(slab->data);
+  delete slab;
+}
+
+
+char* SlabPool::Alloc(size_t length, Slab** slab_out) {
+  assert(IsPoolable(length));
+  const unsigned index = SizeClassIndex(length);
+  SizeClass* sc = &size_classes_[index];
+
+  Slab* slab;
+  if (QUEUE_EMPTY(&sc->partial))
+    slab = NewSlab(index);
+  else
+    slab = QUEUE_DATA(QUEUE_HEAD(&sc->partial), Slab, member);
+
+  char* chunk = slab->free_list;
+  slab->free_list = *reinterpret_cast<char**>(chunk);
+  slab->used += 1;
+  sc->used += 1;
+
+  // Full slabs are taken off the list until a chunk is freed again.
+  if (slab->free_list == NULL) {
+    QUEUE_REMOVE(&slab->member);
+    QUEUE_INIT(&slab->member);
+  }
+
+  *slab_out = slab;
+  return chunk;
+}
+
+
+// FreeCallback, |hint| is the slab that |data| was carved out of.
+void SlabPool::Free(char* data, void* hint) {
+  Slab* slab = static_cast<Slab*>(hint);
+  SizeClass* sc = &size_classes_[slab->size_class];
+  const bool was_full = slab->free_list == NULL;
+
+  *reinterpret_cast<char**>(data) = slab->free_list;
+  slab->free_list = data;
+  slab->used -= 1;
+  sc->used -= 1;
+
+  if (was_full)
+    QUEUE_INSERT_TAIL(&sc->partial, &slab->member);
+
+  // Keep one empty slab per size class around so that a Buffer that is
+  // allocated and collected over and over again doesn't thrash malloc().
+  if (slab->used == 0 && sc->chunks - sc->used > slab->chunks)
+    DeleteSlab(slab);
+}
+
+
+// Pool of read buffers for fs.ReadStream.  Every read gets a chunk of its
+// own, rounded up to a power of two, so a consumer that holds on to the data
+// of one read only keeps that read's chunk alive.  Released chunks are kept
+// on a free list per size, up to max_free_bytes() in total, and handed out
+// again to the next reads of that size.
+class ReadPool {
+ public:
+  static const size_t kMinChunkSize = 4 * 1024;
+  static const unsigned kNumSizeClasses = 13;  // 4 KB to 16 MB.
+
+  struct SizeClass {
+    char* free_list;
+    size_t chunks;  // Chunks that are in use or on the free list.
+    size_t used;
+  };
+
+  static inline size_t ChunkSize(unsigned size_class);
+  static inline bool IsPoolable(size_t length);
+  static char* Alloc(size_t length, void** hint);
+  static void Free(char* data, void* hint);
+  static inline size_t free_bytes();
+  static inline size_t max_free_bytes();
+  static void set_max_free_bytes(size_t size);
+  static inline const SizeClass* size_class(unsigned index);
+
+ private:
+  static size_t free_bytes_;
+  static size_t max_free_bytes_;
+  static SizeClass size_classes_[kNumSizeClasses];
+};
+
+
+size_t ReadPool::free_bytes_;
+size_t ReadPool::max_free_bytes_ = 4 * 1024 * 1024;
+ReadPool::SizeClass ReadPool::size_classes_[ReadPool::kNumSizeClasses];
+
+
+size_t ReadPool::ChunkSize(unsigned size_class) {
+  return kMinChunkSize << size_class;
+}
+
+
+bool ReadPool::IsPoolable(size_t length) {
+  return length > 0 && length <= ChunkSize(kNumSizeClasses - 1);
+}
+
+
+// |hint| is set to the size class of the chunk, it's what Free() expects.
+char* ReadPool::Alloc(size_t length, void** hint) {
+  assert(IsPoolable(length));
+  unsigned index = 0;
+  while (ChunkSize(index) < length)
+    index += 1;
+  SizeClass* sc = &size_classes_[index];
+
+  char* chunk = sc->free_list;
+  if (chunk != NULL) {
+    sc->free_list = *reinterpret_cast<char**>(chunk);
+    free_bytes_ -= ChunkSize(index);
+  } else {
+    chunk = static_cast<char*>(malloc(ChunkSize(index)));
+    if (chunk == NULL)
+      FatalError("node::smalloc::ReadPool::Alloc()", "Out Of Memory");
+    sc->chunks += 1;
+  }
+  sc->used += 1;
+
+  *hint = reinterpret_cast<void*>(static_cast<uintptr_t>(index));
+  return chunk;
+}
+
+
+// FreeCallback, |hint| is the size class that |data| was allocated from.
+void ReadPool::Free(char* data, void* hint) {
+  const unsigned index =
+      static_cast<unsigned>(reinterpret_cast<uintptr_t>(hint));
+  SizeClass* sc = &size_classes_[index];
+  sc->used -= 1;
+
+  if (free_bytes_ + ChunkSize(index) > max_free_bytes_) {
+    sc->chunks -= 1;
+    free(data);
+    return;
+  }
+
+  *reinterpret_cast<char**>(data) = sc->free_list;
+  sc->free_list = data;
+  free_bytes_ += ChunkSize(index);
+}
+
+
+size_t ReadPool::free_bytes() {
+  return free_bytes_;
+}
+
+
+size_t ReadPool::max_free_bytes() {
+  return max_free_bytes_;
+}
+
+
+// Gives cached chunks back to malloc(), biggest first, until the free lists
+// fit in the new limit.
+void ReadPool::set_max_free_bytes(size_t size) {
+  max_free_bytes_ = size;
+  for (unsigned i = kNumSizeClasses; i > 0 && free_bytes_ > size; i -= 1) {
+    SizeClass* sc = &size_classes_[i - 1];
+    while (sc->free_list != NULL && free_bytes_ > size) {
+      char* chunk = sc->free_list;
+      sc->free_list = *reinterpret_cast<char**>(chunk);
+      sc->chunks -= 1;
+      free_bytes_ -= ChunkSize(i - 1);
+      free(chunk);
+    }
+  }
+}
+
+
+const ReadPool::SizeClass* ReadPool::size_class(unsigned index) {
+  return &size_classes_[index];
+}
+
+
 // return size of external array type, or 0 if unrecognized
 size_t ExternalArraySize(enum ExternalArrayType type) {
   switch (type) {
@@ -317,6 +636,164 @@ void Alloc(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+// for internal use:
+//    poolAlloc(obj, n);
+// Buffers that are too big for the pool are allocated with malloc().
+void PoolAlloc(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args.GetIsolate());
+  HandleScope scope(env->isolate());
+
+  Local<Object> obj = args[0].As<Object>();
+
+  // can't perform this check in JS
+  if (obj->HasIndexedPropertiesInExternalArrayData())
+    return env->ThrowTypeError("object already has external array data");
+
+  size_t length = args[1]->Uint32Value();
+  args.GetReturnValue().Set(obj);
+
+  if (!SlabPool::IsPoolable(length))
+    return Alloc(env, obj, length, kExternalUnsignedByteArray);
+
+  SlabPool::Slab* slab;
+  char* data = SlabPool::Alloc(length, &slab);
+  Alloc(env,
+        obj,
+        data,
+        length,
+        SlabPool::Free,
+        slab,
+        kExternalUnsignedByteArray);
+}
+
+
+// for internal use: setPoolSize(n);
+void SetPoolSize(const FunctionCallbackInfo<Value>& args) {
+  SlabPool::set_pool_size(args[0]->Uint32Value());
+}
+
+
+// poolStats() returns an object with the overall occupancy of the pool and
+// an array with the same numbers broken down by size class.  Size classes
+// that were never used are left out.
+void PoolStats(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args.GetIsolate());
+  Isolate* isolate = env->isolate();
+  HandleScope scope(isolate);
+
+  Local<Array> classes = Array::New(isolate);
+  double total_bytes = 0;
+  double used_bytes = 0;
+
+  for (unsigned i = 0, n = 0; i < SlabPool::kNumSizeClasses; i += 1) {
+    const SlabPool::SizeClass* sc = SlabPool::size_class(i);
+    if (sc->slabs == 0 && sc->used == 0)
+      continue;
+    const double chunk_size = SlabPool::ChunkSize(i);
+    Local<Object> stats = Object::New(isolate);
+    stats->Set(FIXED_ONE_BYTE_STRING(isolate, "chunkSize"),
+               Number::New(isolate, chunk_size));
+    stats->Set(FIXED_ONE_BYTE_STRING(isolate, "slabs"),
+               Number::New(isolate, sc->slabs));
+    stats->Set(FIXED_ONE_BYTE_STRING(isolate, "chunks"),
+               Number::New(isolate, sc->chunks));
+    stats->Set(FIXED_ONE_BYTE_STRING(isolate, "used"),
+               Number::New(isolate, sc->used));
+    classes->Set(n++, stats);
+    total_bytes += chunk_size * sc->chunks;
+    used_bytes += chunk_size * sc->used;
+  }
+
+  Local<Object> stats = Object::New(isolate);
+  stats->Set(FIXED_ONE_BYTE_STRING(isolate, "poolSize"),
+             Number::New(isolate, SlabPool::pool_size()));
+  stats->Set(FIXED_ONE_BYTE_STRING(isolate, "totalBytes"),
+             Number::New(isolate, total_bytes));
+  stats->Set(FIXED_ONE_BYTE_STRING(isolate, "usedBytes"),
+             Number::New(isolate, used_bytes));
+  stats->Set(FIXED_ONE_BYTE_STRING(isolate, "sizeClasses"), classes);
+  args.GetReturnValue().Set(stats);
+}
+
+
+// for internal use:
+//    buffer = readPoolAlloc(n);
+// Returns a Buffer of length |n| for fs.ReadStream to read into.  Disposing
+// of it puts its chunk back in the pool right away.
+void ReadPoolAlloc(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args.GetIsolate());
+  HandleScope scope(env->isolate());
+
+  size_t length = args[0]->Uint32Value();
+  Local<Value> arg = Uint32::NewFromUnsigned(env->isolate(), length);
+  Local<Object> obj = env->buffer_constructor_function()->NewInstance(1, &arg);
+  args.GetReturnValue().Set(obj);
+
+  if (!ReadPool::IsPoolable(length))
+    return Alloc(env, obj, length, kExternalUnsignedByteArray);
+
+  void* hint;
+  char* data = ReadPool::Alloc(length, &hint);
+  Alloc(env,
+        obj,
+        data,
+        length,
+        ReadPool::Free,
+        hint,
+        kExternalUnsignedByteArray);
+}
+
+
+// for internal use: setReadPoolLimit(n);
+void SetReadPoolLimit(const FunctionCallbackInfo<Value>& args) {
+  ReadPool::set_max_free_bytes(args[0]->Uint32Value());
+}
+
+
+// readPoolStats() is like poolStats() for the fs.ReadStream pool.  |free| is
+// the number of released chunks that are cached for reuse.
+void ReadPoolStats(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args.GetIsolate());
+  Isolate* isolate = env->isolate();
+  HandleScope scope(isolate);
+
+  Local<Array> classes = Array::New(isolate);
+  double total_bytes = 0;
+  double used_bytes = 0;
+
+  for (unsigned i = 0, n = 0; i < ReadPool::kNumSizeClasses; i += 1) {
+    const ReadPool::SizeClass* sc = ReadPool::size_class(i);
+    if (sc->chunks == 0)
+      continue;
+    const double chunk_size = ReadPool::ChunkSize(i);
+    Local<Object> stats = Object::New(isolate);
+    stats->Set(FIXED_ONE_BYTE_STRING(isolate, "chunkSize"),
+               Number::New(isolate, chunk_size));
+    stats->Set(FIXED_ONE_BYTE_STRING(isolate, "chunks"),
+               Number::New(isolate, sc->chunks));
+    stats->Set(FIXED_ONE_BYTE_STRING(isolate, "used"),
+               Number::New(isolate, sc->used));
+    stats->Set(FIXED_ONE_BYTE_STRING(isolate, "free"),
+               Number::New(isolate, sc->chunks - sc->used));
+    classes->Set(n++, stats);
+    total_bytes += chunk_size * sc->chunks;
+    used_bytes += chunk_size * sc->used;
+  }
+
+  Local<Object> stats = Object::New(isolate);
+  stats->Set(FIXED_ONE_BYTE_STRING(isolate, "limit"),
+             Number::New(isolate, ReadPool::max_free_bytes()));
+  stats->Set(FIXED_ONE_BYTE_STRING(isolate, "totalBytes"),
+             Number::New(isolate, total_bytes));
+  stats->Set(FIXED_ONE_BYTE_STRING(isolate, "usedBytes"),
+             Number::New(isolate, used_bytes));
+  stats->Set(FIXED_ONE_BYTE_STRING(isolate, "freeBytes"),
+             Number::New(isolate, ReadPool::free_bytes()));
+  stats->Set(FIXED_ONE_BYTE_STRING(isolate, "sizeClasses"), classes);
+  args.GetReturnValue().Set(stats);
+}
+
+
 void Alloc(Environment* env,
            Handle<Object> obj,
            size_t length,
@@ -539,10 +1016,18 @@ void Initialize(Handle<Object> exports,
                 Handle<Context> context) {
   Environment* env = Environment::GetCurrent(context);
 
+  SlabPool::Init();
+
   NODE_SET_METHOD(exports, "copyOnto", CopyOnto);
   NODE_SET_METHOD(exports, "sliceOnto", SliceOnto);
 
   NODE_SET_METHOD(exports, "alloc", Alloc);
+  NODE_SET_METHOD(exports, "poolAlloc", PoolAlloc);
+  NODE_SET_METHOD(exports, "setPoolSize", SetPoolSize);
+  NODE_SET_METHOD(exports, "poolStats", PoolStats);
+  NODE_SET_METHOD(exports, "readPoolAlloc", ReadPoolAlloc);
+  NODE_SET_METHOD(exports, "setReadPoolLimit", SetReadPoolLimit);
+  NODE_SET_METHOD(exports, "readPoolStats", ReadPoolStats);
   NODE_SET_METHOD(exports, "dispose", AllocDispose);
   NODE_SET_METHOD(exports, "truncate", AllocTruncate);
 
@@ -36,10 +36,18 @@
 #include <string.h>  // memcpy()
 #include <limits.h>  // INT_MAX
 
+#if defined(__linux__)
+# include <errno.h>
+# include <fcntl.h>
+# include <sys/sendfile.h>
+# include <unistd.h>
+#endif
+
 
 namespace node {
 
 using v8::Array;
+using v8::Boolean;
 using v8::Context;
 using v8::EscapableHandleScope;
 using v8::FunctionCallbackInfo;
@@ -63,7 +71,8 @@ StreamWrap::StreamWrap(Environment* env,
     : HandleWrap(env, object, reinterpret_cast<uv_handle_t*>(stream), provider),
       stream_(stream),
       default_callbacks_(this),
-      callbacks_(&default_callbacks_) {
+      callbacks_(&default_callbacks_),
+      send_file_(NULL) {
 }
 
 
@@ -140,6 +149,21 @@ static Local<Object> AcceptHandle(Environment* env, uv_stream_t* pipe) {
 }
 
 
+// Returns an empty handle when there is nothing pending.
+static Local<Object> AcceptPendingHandle(Environment* env,
+                                         uv_stream_t* handle,
+                                         uv_handle_type pending) {
+  if (pending == UV_TCP)
+    return AcceptHandle<TCPWrap, uv_tcp_t>(env, handle);
+  if (pending == UV_NAMED_PIPE)
+    return AcceptHandle<PipeWrap, uv_pipe_t>(env, handle);
+  if (pending == UV_UDP)
+    return AcceptHandle<UDPWrap, uv_udp_t>(env, handle);
+  assert(pending == UV_UNKNOWN_HANDLE);
+  return Local<Object>();
+}
+
+
 void StreamWrap::OnReadCommon(uv_stream_t* handle,
                               ssize_t nread,
                               const uv_buf_t* buf,
@@ -456,11 +480,21 @@ void StreamWrap::Writev(const FunctionCallbackInfo<Value>& args) {
     bytes += str_size;
   }
 
-  int err = wrap->callbacks()->DoWrite(req_wrap,
-                                       bufs,
-                                       count,
-                                       NULL,
-                                       StreamWrap::AfterWrite);
+  uv_handle_t* send_handle = NULL;
+  if (wrap->is_named_pipe_ipc() && args[2]->IsObject()) {
+    Local<Object> send_handle_obj = args[2].As<Object>();
+    send_handle = Unwrap<HandleWrap>(send_handle_obj)->GetHandle();
+    // Reference StreamWrap instance to prevent it from being garbage
+    // collected before `AfterWrite` is called.
+    req_wrap->object()->Set(env->handle_string(), send_handle_obj);
+  }
+
+  int err = wrap->callbacks()->DoWrite(
+      req_wrap,
+      bufs,
+      count,
+      reinterpret_cast<uv_stream_t*>(send_handle),
+      StreamWrap::AfterWrite);
 
   // Deallocate space
   if (bufs != bufs_)
@@ -509,6 +543,14 @@ void StreamWrap::SetBlocking(const FunctionCallbackInfo<Value>& args) {
   args.GetReturnValue().Set(err);
 }
 
+void StreamWrap::SetFramed(const FunctionCallbackInfo<Value>& args) {
+  StreamWrap* wrap = Unwrap<StreamWrap>(args.Holder());
+  assert(wrap->is_named_pipe_ipc());
+  if (wrap->callbacks() == &wrap->default_callbacks_)
+    wrap->OverrideCallbacks(new FrameCallbacks(wrap->callbacks()));
+}
+
+
 void StreamWrap::AfterWrite(uv_write_t* req, int status) {
   WriteWrap* req_wrap = ContainerOf(&WriteWrap::req_, req);
   StreamWrap* wrap = req_wrap->wrap();
@@ -544,6 +586,264 @@ void StreamWrap::AfterWrite(uv_write_t* req, int status) {
 }
 
 
+#if defined(__linux__)
+
+// Sends part of a file over a socket with sendfile(2).  The sendfile() calls
+// run on the threadpool because reading the file can block on disk I/O.
+// When the socket's send buffer fills up, the request waits on the event
+// loop for the socket to become writable again and then goes back to the
+// threadpool.  It works on a duplicate of the socket's file descriptor so
+// that closing the socket halfway can't make it write to a reused one.
+class SendFileWrap : public ReqWrap<uv_work_t> {
+ public:
+  SendFileWrap(Environment* env,
+               Local<Object> object,
+               StreamWrap* wrap,
+               int sock,
+               int file,
+               int64_t offset,
+               int64_t length)
+      : ReqWrap<uv_work_t>(env, object),
+        wrap_(wrap),
+        sock_(sock),
+        file_(file),
+        offset_(offset),
+        remaining_(length),
+        err_(0),
+        again_(false),
+        working_(false),
+        closing_(false),
+        status_(0) {
+    int err = uv_poll_init(env->event_loop(), &poll_handle_, sock_);
+    CHECK_EQ(err, 0);
+  }
+
+  void Start();
+  void Cancel();
+
+ private:
+  // Upper bound on the bytes sent per threadpool job, so that one transfer
+  // to a fast client doesn't hog a threadpool thread indefinitely.
+  static const int64_t kMaxBytesPerJob = 16 * 1024 * 1024;
+
+  static void Work(uv_work_t* req);
+  static void AfterWork(uv_work_t* req, int status);
+  static void OnWritable(uv_poll_t* handle, int status, int events);
+  static void OnClose(uv_handle_t* handle);
+  void Finish(int status);
+
+  StreamWrap* wrap_;  // NULL when the stream has been closed.
+  uv_poll_t poll_handle_;
+  int sock_;
+  int file_;
+  off_t offset_;
+  int64_t remaining_;
+  int err_;
+  bool again_;
+  bool working_;
+  bool closing_;
+  int status_;
+};
+
+
+void SendFileWrap::Start() {
+  working_ = true;
+  int err = uv_queue_work(env()->event_loop(),
+                          &req_,
+                          SendFileWrap::Work,
+                          SendFileWrap::AfterWork);
+  if (err != 0) {
+    working_ = false;
+    Finish(err);
+  }
+}
+
+
+void SendFileWrap::Cancel() {
+  wrap_ = NULL;
+  if (!working_ && !closing_) {
+    uv_poll_stop(&poll_handle_);
+    Finish(UV_ECANCELED);
+  }
+}
+
+
+void SendFileWrap::Work(uv_work_t* work_req) {
+  SendFileWrap* req = ContainerOf(&SendFileWrap::req_, work_req);
+  int64_t budget = kMaxBytesPerJob;
+
+  while (req->remaining_ > 0 && budget > 0) {
+    size_t count = static_cast<size_t>(
+        req->remaining_ < budget ? req->remaining_ : budget);
+
+    ssize_t n;
+    do
+      n = sendfile(req->sock_, req->file_, &req->offset_, count);
+    while (n == -1 && errno == EINTR);
+
+    if (n == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        req->again_ = true;
+      else
+        req->err_ = -errno;
+      return;
+    }
+
+    // The file is shorter than the caller said it was.
+    if (n == 0) {
+      req->err_ = UV_EOF;
+      return;
+    }
+
+    req->remaining_ -= n;
+    budget -= n;
+  }
+}
+
+
+void SendFileWrap::AfterWork(uv_work_t* work_req, int status) {
+  SendFileWrap* req = ContainerOf(&SendFileWrap::req_, work_req);
+  req->working_ = false;
+
+  if (req->wrap_ == NULL)
+    return req->Finish(UV_ECANCELED);
+  if (req->err_ != 0)
+    return req->Finish(req->err_);
+  if (req->remaining_ == 0)
+    return req->Finish(0);
+
+  if (req->again_) {
+    req->again_ = false;
+    int err = uv_poll_start(&req->poll_handle_,
+                            UV_WRITABLE,
+                            SendFileWrap::OnWritable);
+    if (err != 0)
+      req->Finish(err);
+    return;
+  }
+
+  req->Start();
+}
+
+
+void SendFileWrap::OnWritable(uv_poll_t* handle, int status, int events) {
+  SendFileWrap* req = ContainerOf(&SendFileWrap::poll_handle_, handle);
+  uv_poll_stop(handle);
+  if (status < 0)
+    return req->Finish(status);
+  req->Start();
+}
+
+
+void SendFileWrap::Finish(int status) {
+  status_ = status;
+  closing_ = true;
+  uv_close(reinterpret_cast<uv_handle_t*>(&poll_handle_), OnClose);
+}
+
+
+void SendFileWrap::OnClose(uv_handle_t* handle) {
+  SendFileWrap* req = ContainerOf(&SendFileWrap::poll_handle_,
+                                  reinterpret_cast<uv_poll_t*>(handle));
+  close(req->sock_);
+
+  StreamWrap* wrap = req->wrap_;
+  if (wrap == NULL) {
+    // The stream is gone, nobody is left to tell.
+    delete req;
+    return;
+  }
+  wrap->send_file_ = NULL;
+
+  Environment* env = req->env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+
+  Local<Value> argv[] = {
+    Integer::New(env->isolate(), req->status_),
+    wrap->object(),
+    req->object(),
+    Undefined(env->isolate())
+  };
+
+  req->MakeCallback(env->oncomplete_string(), ARRAY_SIZE(argv), argv);
+  delete req;
+}
+
+#endif  // defined(__linux__)
+
+
+void StreamWrap::CancelSendFile() {
+#if defined(__linux__)
+  send_file_->Cancel();
+  send_file_ = NULL;
+#endif
+}
+
+
+/*
+ * Sends part of a file without copying it to user space.
+ *
+ * err = handle.sendFile(req, fd, offset, length)
+ *
+ * 0 req       write request object, completes like a regular write
+ * 1 fd        integer. file descriptor to read from
+ * 2 offset    integer. where to start reading
+ * 3 length    integer. how many bytes to send
+ *
+ * Returns UV_ENOTSUP when the stream can't do zero-copy transfers and
+ * UV_EBUSY while other writes are still pending.
+ */
+void StreamWrap::SendFile(const FunctionCallbackInfo<Value>& args) {
+  HandleScope handle_scope(args.GetIsolate());
+  Environment* env = Environment::GetCurrent(args.GetIsolate());
+
+  StreamWrap* wrap = Unwrap<StreamWrap>(args.Holder());
+
+  assert(args[0]->IsObject());
+  assert(args[1]->IsInt32());
+  assert(args[2]->IsNumber());
+  assert(args[3]->IsNumber());
+
+  Local<Object> req_wrap_obj = args[0].As<Object>();
+  int fd = args[1]->Int32Value();
+  int64_t offset = args[2]->IntegerValue();
+  int64_t length = args[3]->IntegerValue();
+  int err = UV_ENOTSUP;
+
+#if defined(__linux__)
+  if (!wrap->is_tcp() || wrap->callbacks() != &wrap->default_callbacks_) {
+    err = UV_ENOTSUP;
+  } else if (wrap->stream()->write_queue_size != 0 ||
+             wrap->send_file_ != NULL) {
+    err = UV_EBUSY;
+  } else {
+    int sock = fcntl(wrap->stream()->io_watcher.fd, F_DUPFD_CLOEXEC, 0);
+    if (sock == -1) {
+      err = -errno;
+    } else {
+      SendFileWrap* req_wrap = new SendFileWrap(env,
+                                                req_wrap_obj,
+                                                wrap,
+                                                sock,
+                                                fd,
+                                                offset,
+                                                length);
+      req_wrap->Dispatched();
+      req_wrap_obj->Set(env->async(), True(env->isolate()));
+      wrap->send_file_ = req_wrap;
+      req_wrap->Start();
+      err = 0;
+    }
+  }
+#endif
+
+  req_wrap_obj->Set(env->bytes_string(),
+                    Number::New(env->isolate(), static_cast<double>(length)));
+  args.GetReturnValue().Set(err);
+}
+
+
 void StreamWrap::Shutdown(const FunctionCallbackInfo<Value>& args) {
   HandleScope handle_scope(args.GetIsolate());
   Environment* env = Environment::GetCurrent(args.GetIsolate());
@@ -713,17 +1013,7 @@ void StreamWrapCallbacks::DoRead(uv_stream_t* handle,
   assert(static_cast<size_t>(nread) <= buf->len);
   argv[1] = Buffer::Use(env, base, nread);
 
-  Local<Object> pending_obj;
-  if (pending == UV_TCP) {
-    pending_obj = AcceptHandle<TCPWrap, uv_tcp_t>(env, handle);
-  } else if (pending == UV_NAMED_PIPE) {
-    pending_obj = AcceptHandle<PipeWrap, uv_pipe_t>(env, handle);
-  } else if (pending == UV_UDP) {
-    pending_obj = AcceptHandle<UDPWrap, uv_udp_t>(env, handle);
-  } else {
-    assert(pending == UV_UNKNOWN_HANDLE);
-  }
-
+  Local<Object> pending_obj = AcceptPendingHandle(env, handle, pending);
   if (!pending_obj.IsEmpty()) {
     argv[2] = pending_obj;
   }
@@ -736,4 +1026,144 @@ int StreamWrapCallbacks::DoShutdown(ShutdownWrap* req_wrap, uv_shutdown_cb cb) {
   return uv_shutdown(&req_wrap->req_, wrap()->stream(), cb);
 }
 
+
+FrameCallbacks::FrameCallbacks(StreamWrapCallbacks* old)
+    : StreamWrapCallbacks(old),
+      header_read_(0),
+      frame_(NULL),
+      frame_size_(0),
+      frame_read_(0),
+      frame_type_(0) {
+}
+
+
+FrameCallbacks::~FrameCallbacks() {
+  free(frame_);
+  pending_handle_.Reset();
+}
+
+
+void FrameCallbacks::DoAlloc(uv_handle_t* handle,
+                             size_t suggested_size,
+                             uv_buf_t* buf) {
+  if (frame_ == NULL)
+    return StreamWrapCallbacks::DoAlloc(handle, suggested_size, buf);
+  *buf = uv_buf_init(frame_ + frame_read_, frame_size_ - frame_read_);
+}
+
+
+void FrameCallbacks::DoRead(uv_stream_t* handle,
+                            ssize_t nread,
+                            const uv_buf_t* buf,
+                            uv_handle_type pending) {
+  Environment* env = wrap()->env();
+  HandleScope handle_scope(env->isolate());
+  Context::Scope context_scope(env->context());
+
+  const bool in_frame = frame_ != NULL && buf->base == frame_ + frame_read_;
+
+  if (nread <= 0) {
+    if (!in_frame)
+      free(buf->base);
+    if (nread == 0)
+      return;
+    free(frame_);
+    frame_ = NULL;
+    Local<Value> argv[] = { Integer::New(env->isolate(), nread) };
+    wrap()->MakeCallback(env->onread_string(), ARRAY_SIZE(argv), argv);
+    return;
+  }
+
+  // There's at most one handle per read, it goes with the next frame.
+  Local<Object> pending_obj = AcceptPendingHandle(env, handle, pending);
+  if (!pending_obj.IsEmpty())
+    pending_handle_.Reset(env->isolate(), pending_obj);
+
+  if (in_frame) {
+    frame_read_ += nread;
+    if (frame_read_ < frame_size_)
+      return;
+    Local<Object> payload = Buffer::Use(env, frame_, frame_size_);
+    frame_ = NULL;
+    header_read_ = 0;
+    Deliver(payload, false);
+    return;
+  }
+
+  const char* data = buf->base;
+  const char* end = data + nread;
+
+  for (;;) {
+    if (header_read_ < kHeaderSize) {
+      size_t n = kHeaderSize - header_read_;
+      if (n > static_cast<size_t>(end - data))
+        n = end - data;
+      memcpy(header_ + header_read_, data, n);
+      header_read_ += n;
+      data += n;
+      if (header_read_ < kHeaderSize)
+        break;
+
+      const unsigned char* h = reinterpret_cast<unsigned char*>(header_);
+      frame_size_ = (static_cast<size_t>(h[0]) << 24) | (h[1] << 16) |
+                    (h[2] << 8) | h[3];
+      frame_type_ = h[4];
+      frame_read_ = 0;
+
+      if (frame_size_ > Buffer::kMaxLength) {
+        free(buf->base);
+        Local<Value> argv[] = { Integer::New(env->isolate(), UV_EPROTO) };
+        wrap()->MakeCallback(env->onread_string(), ARRAY_SIZE(argv), argv);
+        return;
+      }
+
+      // Too big for the rest of this read, collect it in a buffer of its own.
+      if (frame_size_ > static_cast<size_t>(end - data)) {
+        frame_ = static_cast<char*>(malloc(frame_size_));
+        if (frame_ == NULL)
+          FatalError("node::FrameCallbacks::DoRead()", "Out Of Memory");
+      }
+    }
+
+    if (frame_ != NULL) {
+      size_t n = end - data;
+      memcpy(frame_, data, n);
+      frame_read_ = n;
+      break;
+    }
+
+    Local<Object> payload = Buffer::New(env, data, frame_size_);
+    data += frame_size_;
+    header_read_ = 0;
+    if (!Deliver(payload, data < end))
+      break;
+  }
+
+  free(buf->base);
+}
+
+
+// Calls onread(length, payload, handle, type, partial), where |partial| tells
+// that the next frame has been started.  Returns false when the stream was
+// closed by the callback.
+bool FrameCallbacks::Deliver(Local<Object> payload, bool partial) {
+  Environment* env = wrap()->env();
+
+  Local<Value> argv[] = {
+    Integer::NewFromUnsigned(env->isolate(), Buffer::Length(payload)),
+    payload,
+    Undefined(env->isolate()),
+    Integer::New(env->isolate(), frame_type_),
+    Boolean::New(env->isolate(), partial || frame_ != NULL)
+  };
+
+  if (!pending_handle_.IsEmpty()) {
+    argv[2] = Local<Object>::New(env->isolate(), pending_handle_);
+    pending_handle_.Reset();
+  }
+
+  wrap()->MakeCallback(env->onread_string(), ARRAY_SIZE(argv), argv);
+  return !uv_is_closing(reinterpret_cast<uv_handle_t*>(wrap()->stream()));
+}
+
 }  // namespace node
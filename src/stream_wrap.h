@@ -31,6 +31,7 @@
 namespace node {
 
 // Forward declaration
+class SendFileWrap;
 class StreamWrap;
 
 typedef class ReqWrap<uv_shutdown_t> ShutdownWrap;
@@ -103,6 +104,38 @@ class StreamWrapCallbacks {
   StreamWrap* const wrap_;
 };
 
+// Splits what is read from an IPC pipe into frames of a 32 bits big endian
+// payload length, a type byte and the payload, and hands each payload to JS
+// as a Buffer of its own.
+class FrameCallbacks : public StreamWrapCallbacks {
+ public:
+  static const size_t kHeaderSize = 5;
+
+  explicit FrameCallbacks(StreamWrapCallbacks* old);
+  virtual ~FrameCallbacks();
+
+  virtual void DoAlloc(uv_handle_t* handle,
+                       size_t suggested_size,
+                       uv_buf_t* buf);
+  virtual void DoRead(uv_stream_t* handle,
+                      ssize_t nread,
+                      const uv_buf_t* buf,
+                      uv_handle_type pending);
+
+ private:
+  bool Deliver(v8::Local<v8::Object> payload, bool partial);
+
+  char header_[kHeaderSize];
+  size_t header_read_;
+  // Frames that didn't arrive in one read are read straight into frame_.
+  char* frame_;
+  size_t frame_size_;
+  size_t frame_read_;
+  int frame_type_;
+  // A handle that arrived before the frame that it belongs to was complete.
+  v8::Persistent<v8::Object> pending_handle_;
+};
+
 class StreamWrap : public HandleWrap {
  public:
   void OverrideCallbacks(StreamWrapCallbacks* callbacks) {
@@ -128,6 +161,13 @@ class StreamWrap : public HandleWrap {
 
   static void SetBlocking(const v8::FunctionCallbackInfo<v8::Value>& args);
 
+  // Switches reads to FrameCallbacks, for IPC pipes.
+  static void SetFramed(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  // Zero-copy file to socket transfer, TCP only.  Returns UV_ENOTSUP when
+  // the data has to pass through user space, e.g. for TLS.
+  static void SendFile(const v8::FunctionCallbackInfo<v8::Value>& args);
+
   inline StreamWrapCallbacks* callbacks() const {
     return callbacks_;
   }
@@ -158,6 +198,8 @@ class StreamWrap : public HandleWrap {
              AsyncWrap::ProviderType provider);
 
   ~StreamWrap() {
+    if (send_file_ != NULL)
+      CancelSendFile();
     if (callbacks_ != &default_callbacks_) {
       delete callbacks_;
       callbacks_ = NULL;
@@ -186,10 +228,14 @@ class StreamWrap : public HandleWrap {
   template <enum encoding encoding>
   static void WriteStringImpl(const v8::FunctionCallbackInfo<v8::Value>& args);
 
+  void CancelSendFile();
+
   uv_stream_t* const stream_;
   StreamWrapCallbacks default_callbacks_;
   StreamWrapCallbacks* callbacks_;  // Overridable callbacks
+  SendFileWrap* send_file_;  // In-flight SendFile() request, if any.
 
+  friend class SendFileWrap;
   friend class StreamWrapCallbacks;
 };
 
@@ -29,6 +29,27 @@
 #include <limits.h>
 #include <string.h>  // memcpy
 
+// The SSE2/SSSE3/AVX2 kernels below are compiled with per-function target
+// attributes and picked at runtime based on what the CPU supports.  They
+// only ever handle the bulk of the input; the scalar code takes care of the
+// tail and of anything the kernels can't handle, like whitespace in base64.
+#ifndef __has_builtin
+# define __has_builtin(x) 0
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) &&                             \
+    ((defined(__clang__) && __has_builtin(__builtin_cpu_supports)) ||         \
+     (!defined(__clang__) && defined(__GNUC__) &&                             \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+# define NODE_HAVE_SIMD_KERNELS 1
+#else
+# define NODE_HAVE_SIMD_KERNELS 0
+#endif
+
+#if NODE_HAVE_SIMD_KERNELS
+#include <immintrin.h>
+#endif
+
 // When creating strings >= this length v8's gc spins up and consumes
 // most of the execution time. For these cases it's more performant to
 // use external string resources.
@@ -113,6 +134,339 @@ typedef ExternString<String::ExternalStringResource,
                      uint16_t> ExternTwoByteString;
 
 
+//// SIMD ////
+
+#if NODE_HAVE_SIMD_KERNELS
+
+#define NODE_SIMD_TARGET(isa) __attribute__((target(isa)))
+
+enum SimdFeatures {
+  kSimdSSE2 = 1,
+  kSimdSSSE3 = 2,
+  kSimdAVX2 = 4
+};
+
+
+static unsigned DetectSimdFeatures() {
+  // Needed because we run from a static initializer.
+  __builtin_cpu_init();
+  unsigned features = 0;
+  if (__builtin_cpu_supports("sse2"))
+    features |= kSimdSSE2;
+  if (__builtin_cpu_supports("ssse3"))
+    features |= kSimdSSSE3;
+  if (__builtin_cpu_supports("avx2"))
+    features |= kSimdAVX2;
+  return features;
+}
+
+
+static const unsigned simd_features = DetectSimdFeatures();
+
+
+// Spreads the 12 input bytes in the low 96 bits of |in| over 16 bytes,
+// six bits per byte.  See http://0x80.pl/notesen/2016-01-12-sse-base64-encoding.html
+NODE_SIMD_TARGET("ssse3")
+static inline __m128i base64_encode_reshuffle_ssse3(__m128i in) {
+  in = _mm_shuffle_epi8(in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4,
+                                          7, 6, 8, 7, 10, 9, 11, 10));
+  const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+  const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+  const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+  const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+  return _mm_or_si128(t1, t3);
+}
+
+
+// Maps 6 bit values to "A-Za-z0-9+/".
+NODE_SIMD_TARGET("ssse3")
+static inline __m128i base64_encode_translate_ssse3(__m128i in) {
+  const __m128i lut = _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4,
+                                    -4, -4, -4, -4, -19, -16, 0, 0);
+  __m128i indices = _mm_subs_epu8(in, _mm_set1_epi8(51));
+  indices = _mm_sub_epi8(indices, _mm_cmpgt_epi8(in, _mm_set1_epi8(25)));
+  return _mm_add_epi8(in, _mm_shuffle_epi8(lut, indices));
+}
+
+
+NODE_SIMD_TARGET("ssse3")
+static void base64_encode_ssse3(const char* src,
+                                size_t slen,
+                                char* dst,
+                                size_t* i,
+                                size_t* k) {
+  // Loads 16 bytes but consumes only 12 per iteration.
+  while (slen - *i >= 16) {
+    __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + *i));
+    in = base64_encode_translate_ssse3(base64_encode_reshuffle_ssse3(in));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + *k), in);
+    *i += 12;
+    *k += 16;
+  }
+}
+
+
+NODE_SIMD_TARGET("avx2")
+static void base64_encode_avx2(const char* src,
+                               size_t slen,
+                               char* dst,
+                               size_t* i,
+                               size_t* k) {
+  const __m256i shuf = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4,
+                                        7, 6, 8, 7, 10, 9, 11, 10,
+                                        1, 0, 2, 1, 4, 3, 5, 4,
+                                        7, 6, 8, 7, 10, 9, 11, 10);
+  const __m256i lut = _mm256_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4,
+                                       -4, -4, -4, -4, -19, -16, 0, 0,
+                                       65, 71, -4, -4, -4, -4, -4, -4,
+                                       -4, -4, -4, -4, -19, -16, 0, 0);
+  // Same as the SSSE3 kernel, with 12 input bytes in each 128 bits lane.
+  while (slen - *i >= 28) {
+    const char* p = src + *i;
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 0));
+    __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 12));
+    __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+    in = _mm256_shuffle_epi8(in, shuf);
+    const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+    const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+    const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    in = _mm256_or_si256(t1, t3);
+    __m256i indices = _mm256_subs_epu8(in, _mm256_set1_epi8(51));
+    indices = _mm256_sub_epi8(indices,
+                              _mm256_cmpgt_epi8(in, _mm256_set1_epi8(25)));
+    in = _mm256_add_epi8(in, _mm256_shuffle_epi8(lut, indices));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + *k), in);
+    *i += 24;
+    *k += 32;
+  }
+}
+
+
+// Decodes 16 characters from the standard base64 alphabet into 12 bytes in
+// the low 96 bits of |*out|.  Returns false if |in| contains anything else,
+// i.e. whitespace, padding or characters from the URL-safe alphabet.
+NODE_SIMD_TARGET("ssse3")
+static inline bool base64_decode_block_ssse3(__m128i in, __m128i* out) {
+  const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11,
+                                       0x11, 0x11, 0x11, 0x11,
+                                       0x11, 0x11, 0x13, 0x1A,
+                                       0x1B, 0x1B, 0x1B, 0x1A);
+  const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02,
+                                       0x04, 0x08, 0x04, 0x08,
+                                       0x10, 0x10, 0x10, 0x10,
+                                       0x10, 0x10, 0x10, 0x10);
+  const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                         0, 0, 0, 0, 0, 0, 0, 0);
+  const __m128i nibble = _mm_set1_epi8(0x0f);
+  const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), nibble);
+  const __m128i lo_nibbles = _mm_and_si128(in, nibble);
+  const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+  const __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+  const __m128i zero = _mm_setzero_si128();
+  if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), zero)) != 0xffff)
+    return false;
+  const __m128i eq_2f = _mm_cmpeq_epi8(in, _mm_set1_epi8(0x2f));
+  const __m128i roll = _mm_shuffle_epi8(lut_roll,
+                                        _mm_add_epi8(eq_2f, hi_nibbles));
+  in = _mm_add_epi8(in, roll);
+  in = _mm_maddubs_epi16(in, _mm_set1_epi32(0x01400140));
+  in = _mm_madd_epi16(in, _mm_set1_epi32(0x00011000));
+  *out = _mm_shuffle_epi8(in, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9,
+                                            8, 14, 13, 12, -1, -1, -1, -1));
+  return true;
+}
+
+
+NODE_SIMD_TARGET("ssse3")
+static void base64_decode_ssse3(char* dst,
+                                size_t dlen,
+                                const char* src,
+                                size_t slen,
+                                size_t* i,
+                                size_t* k) {
+  // Stores 16 bytes but produces only 12 per iteration.
+  while (slen - *i >= 16 && dlen - *k >= 16) {
+    __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + *i));
+    if (!base64_decode_block_ssse3(in, &in))
+      break;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + *k), in);
+    *i += 16;
+    *k += 12;
+  }
+}
+
+
+NODE_SIMD_TARGET("avx2")
+static void base64_decode_avx2(char* dst,
+                               size_t dlen,
+                               const char* src,
+                               size_t slen,
+                               size_t* i,
+                               size_t* k) {
+  const __m256i lut_lo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11,
+                                          0x11, 0x11, 0x11, 0x11,
+                                          0x11, 0x11, 0x13, 0x1A,
+                                          0x1B, 0x1B, 0x1B, 0x1A,
+                                          0x15, 0x11, 0x11, 0x11,
+                                          0x11, 0x11, 0x11, 0x11,
+                                          0x11, 0x11, 0x13, 0x1A,
+                                          0x1B, 0x1B, 0x1B, 0x1A);
+  const __m256i lut_hi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02,
+                                          0x04, 0x08, 0x04, 0x08,
+                                          0x10, 0x10, 0x10, 0x10,
+                                          0x10, 0x10, 0x10, 0x10,
+                                          0x10, 0x10, 0x01, 0x02,
+                                          0x04, 0x08, 0x04, 0x08,
+                                          0x10, 0x10, 0x10, 0x10,
+                                          0x10, 0x10, 0x10, 0x10);
+  const __m256i lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                            0, 0, 0, 0, 0, 0, 0, 0,
+                                            0, 16, 19, 4, -65, -65, -71, -71,
+                                            0, 0, 0, 0, 0, 0, 0, 0);
+  const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9,
+                                        8, 14, 13, 12, -1, -1, -1, -1,
+                                        2, 1, 0, 6, 5, 4, 10, 9,
+                                        8, 14, 13, 12, -1, -1, -1, -1);
+  const __m256i nibble = _mm256_set1_epi8(0x0f);
+  const __m256i zero = _mm256_setzero_si256();
+  // Same as the SSSE3 kernel but the two lanes are compacted into 24 bytes.
+  while (slen - *i >= 32 && dlen - *k >= 32) {
+    __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + *i));
+    const __m256i hi_nibbles =
+        _mm256_and_si256(_mm256_srli_epi32(in, 4), nibble);
+    const __m256i lo_nibbles = _mm256_and_si256(in, nibble);
+    const __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+    const __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+    const __m256i valid = _mm256_cmpeq_epi8(_mm256_and_si256(lo, hi), zero);
+    if (_mm256_movemask_epi8(valid) != -1)
+      break;
+    const __m256i eq_2f = _mm256_cmpeq_epi8(in, _mm256_set1_epi8(0x2f));
+    const __m256i roll =
+        _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles));
+    in = _mm256_add_epi8(in, roll);
+    in = _mm256_maddubs_epi16(in, _mm256_set1_epi32(0x01400140));
+    in = _mm256_madd_epi16(in, _mm256_set1_epi32(0x00011000));
+    in = _mm256_shuffle_epi8(in, pack);
+    in = _mm256_permutevar8x32_epi32(in, _mm256_setr_epi32(0, 1, 2, 4,
+                                                           5, 6, 7, 7));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + *k), in);
+    *i += 32;
+    *k += 24;
+  }
+}
+
+
+// Maps nibbles to "0-9a-f".
+NODE_SIMD_TARGET("sse2")
+static inline __m128i hex_encode_translate_sse2(__m128i in) {
+  const __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8(9)),
+                                      _mm_set1_epi8('a' - '0' - 10));
+  return _mm_add_epi8(_mm_add_epi8(in, _mm_set1_epi8('0')), alpha);
+}
+
+
+NODE_SIMD_TARGET("sse2")
+static void hex_encode_sse2(const char* src,
+                            size_t slen,
+                            char* dst,
+                            size_t* i,
+                            size_t* k) {
+  const __m128i nibble = _mm_set1_epi8(0x0f);
+  while (slen - *i >= 16) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + *i));
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(in, 4), nibble);
+    __m128i lo = _mm_and_si128(in, nibble);
+    hi = hex_encode_translate_sse2(hi);
+    lo = hex_encode_translate_sse2(lo);
+    __m128i* out = reinterpret_cast<__m128i*>(dst + *k);
+    _mm_storeu_si128(out + 0, _mm_unpacklo_epi8(hi, lo));
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi8(hi, lo));
+    *i += 16;
+    *k += 32;
+  }
+}
+
+
+// Maps "0-9a-fA-F" to nibbles.  Lanes that don't hold a hex digit are
+// cleared in |*valid|.
+NODE_SIMD_TARGET("sse2")
+static inline __m128i hex_decode_translate_sse2(__m128i in, __m128i* valid) {
+  const __m128i minus_one = _mm_set1_epi8(-1);
+  const __m128i digit = _mm_sub_epi8(in, _mm_set1_epi8('0'));
+  const __m128i is_digit =
+      _mm_and_si128(_mm_cmpgt_epi8(digit, minus_one),
+                    _mm_cmplt_epi8(digit, _mm_set1_epi8(10)));
+  const __m128i alpha = _mm_sub_epi8(_mm_or_si128(in, _mm_set1_epi8(0x20)),
+                                     _mm_set1_epi8('a'));
+  const __m128i is_alpha =
+      _mm_and_si128(_mm_cmpgt_epi8(alpha, minus_one),
+                    _mm_cmplt_epi8(alpha, _mm_set1_epi8(6)));
+  *valid = _mm_or_si128(is_digit, is_alpha);
+  return _mm_or_si128(
+      _mm_and_si128(is_digit, digit),
+      _mm_and_si128(is_alpha, _mm_add_epi8(alpha, _mm_set1_epi8(10))));
+}
+
+
+// Merges pairs of nibbles into bytes, one byte per 16 bits lane.
+NODE_SIMD_TARGET("sse2")
+static inline __m128i hex_decode_merge_sse2(__m128i in) {
+  const __m128i hi = _mm_slli_epi16(_mm_and_si128(in, _mm_set1_epi16(0xff)), 4);
+  const __m128i lo = _mm_srli_epi16(in, 8);
+  return _mm_or_si128(hi, lo);
+}
+
+
+NODE_SIMD_TARGET("sse2")
+static void hex_decode_sse2(char* dst,
+                            size_t dlen,
+                            const char* src,
+                            size_t slen,
+                            size_t* i) {
+  while (dlen - *i >= 16 && slen - *i * 2 >= 32) {
+    const __m128i* in = reinterpret_cast<const __m128i*>(src + *i * 2);
+    __m128i a_valid;
+    __m128i b_valid;
+    __m128i a = hex_decode_translate_sse2(_mm_loadu_si128(in + 0), &a_valid);
+    __m128i b = hex_decode_translate_sse2(_mm_loadu_si128(in + 1), &b_valid);
+    if (_mm_movemask_epi8(_mm_and_si128(a_valid, b_valid)) != 0xffff)
+      break;
+    a = hex_decode_merge_sse2(a);
+    b = hex_decode_merge_sse2(b);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + *i),
+                     _mm_packus_epi16(a, b));
+    *i += 16;
+  }
+}
+
+
+NODE_SIMD_TARGET("sse2")
+static bool contains_non_ascii_sse2(const char* src, size_t len, size_t* i) {
+  // Check 64 bytes per iteration, that's enough to saturate the load ports.
+  while (len - *i >= 64) {
+    const __m128i* p = reinterpret_cast<const __m128i*>(src + *i);
+    const __m128i a = _mm_or_si128(_mm_loadu_si128(p + 0),
+                                   _mm_loadu_si128(p + 1));
+    const __m128i b = _mm_or_si128(_mm_loadu_si128(p + 2),
+                                   _mm_loadu_si128(p + 3));
+    if (_mm_movemask_epi8(_mm_or_si128(a, b)) != 0)
+      return true;
+    *i += 64;
+  }
+  while (len - *i >= 16) {
+    const __m128i* p = reinterpret_cast<const __m128i*>(src + *i);
+    if (_mm_movemask_epi8(_mm_loadu_si128(p)) != 0)
+      return true;
+    *i += 16;
+  }
+  return false;
+}
+
+#endif  // NODE_HAVE_SIMD_KERNELS
+
+
 //// Base 64 ////
 
 #define base64_encoded_size(size) ((size + 2 - ((size + 2) % 3)) / 3 * 4)
@@ -172,55 +526,109 @@ static const int unbase64_table[] =
 #define unbase64(x) unbase64_table[(uint8_t)(x)]
 
 
+// Decodes the next group of four characters, skipping over characters that
+// are not part of the alphabet.  Returns false when it runs out of input or
+// output space.
 template <typename TypeName>
-size_t base64_decode(char* buf,
-                     size_t len,
-                     const TypeName* src,
-                     const size_t srcLen) {
-  char a, b, c, d;
-  char* dst = buf;
-  char* dstEnd = buf + len;
-  const TypeName* srcEnd = src + srcLen;
+static bool base64_decode_group_slow(char* dst,
+                                     const size_t dstlen,
+                                     const TypeName* src,
+                                     const size_t srclen,
+                                     size_t* i,
+                                     size_t* k) {
+  int a, b, c, d;
+
+#define V(var)                                                                \
+  while (*i < srclen && unbase64(src[*i]) < 0)                                \
+    *i += 1;                                                                  \
+  if (*i >= srclen)                                                           \
+    return false;                                                             \
+  var = unbase64(src[*i]);                                                    \
+  *i += 1;
+
+  V(a);
+  V(b);
+  dst[(*k)++] = (a << 2) | ((b & 0x30) >> 4);
+  if (*k >= dstlen)
+    return false;
 
-  while (src < srcEnd && dst < dstEnd) {
-    int remaining = srcEnd - src;
+  V(c);
+  dst[(*k)++] = ((b & 0x0F) << 4) | ((c & 0x3C) >> 2);
+  if (*k >= dstlen)
+    return false;
 
-    while (unbase64(*src) < 0 && src < srcEnd)
-      src++, remaining--;
-    if (remaining == 0 || *src == '=')
-      break;
-    a = unbase64(*src++);
+  V(d);
+  dst[(*k)++] = ((c & 0x03) << 6) | (d & 0x3F);
+#undef V
 
-    while (unbase64(*src) < 0 && src < srcEnd)
-      src++, remaining--;
-    if (remaining <= 1 || *src == '=')
-      break;
-    b = unbase64(*src++);
+  return true;
+}
 
-    *dst++ = (a << 2) | ((b & 0x30) >> 4);
-    if (dst == dstEnd)
-      break;
 
-    while (unbase64(*src) < 0 && src < srcEnd)
-      src++, remaining--;
-    if (remaining <= 2 || *src == '=')
-      break;
-    c = unbase64(*src++);
+// Returns the number of bytes decoded by the vectorized kernels, which only
+// exist for one-byte input.  |*i| is updated to point past the characters
+// that were consumed.
+template <typename TypeName>
+static inline size_t base64_decode_simd(char* dst,
+                                        size_t dstlen,
+                                        const TypeName* src,
+                                        size_t srclen,
+                                        size_t* i) {
+  return 0;
+}
 
-    *dst++ = ((b & 0x0F) << 4) | ((c & 0x3C) >> 2);
-    if (dst == dstEnd)
-      break;
 
-    while (unbase64(*src) < 0 && src < srcEnd)
-      src++, remaining--;
-    if (remaining <= 3 || *src == '=')
-      break;
-    d = unbase64(*src++);
+static inline size_t base64_decode_simd(char* dst,
+                                        size_t dstlen,
+                                        const char* src,
+                                        size_t srclen,
+                                        size_t* i) {
+  size_t k = 0;
+#if NODE_HAVE_SIMD_KERNELS
+  if (simd_features & kSimdAVX2)
+    base64_decode_avx2(dst, dstlen, src, srclen, i, &k);
+  if (simd_features & kSimdSSSE3)
+    base64_decode_ssse3(dst, dstlen, src, srclen, i, &k);
+#endif
+  return k;
+}
+
 
-    *dst++ = ((c & 0x03) << 6) | (d & 0x3F);
+template <typename TypeName>
+size_t base64_decode(char* buf,
+                     size_t len,
+                     const TypeName* src,
+                     const size_t srcLen) {
+  size_t i = 0;
+  size_t k = 0;
+
+  while (i < srcLen && k < len) {
+    k += base64_decode_simd(buf + k, len - k, src, srcLen, &i);
+
+    // The kernels stop at the first block with whitespace, padding or
+    // URL-safe characters in it.  Work past that block a group at a time.
+    const size_t block_end = i + 16;
+    while (i < block_end && i < srcLen && k < len) {
+      if (srcLen - i >= 4 && len - k >= 3) {
+        const int a = unbase64(src[i + 0]);
+        const int b = unbase64(src[i + 1]);
+        const int c = unbase64(src[i + 2]);
+        const int d = unbase64(src[i + 3]);
+        if ((a | b | c | d) >= 0) {
+          buf[k + 0] = (a << 2) | ((b & 0x30) >> 4);
+          buf[k + 1] = ((b & 0x0F) << 4) | ((c & 0x3C) >> 2);
+          buf[k + 2] = ((c & 0x03) << 6) | (d & 0x3F);
+          i += 4;
+          k += 3;
+          continue;
+        }
+      }
+      if (!base64_decode_group_slow(buf, len, src, srcLen, &i, &k))
+        return k;
+    }
   }
 
-  return dst - buf;
+  return k;
 }
 
 
@@ -238,13 +646,37 @@ unsigned hex2bin(TypeName c) {
 }
 
 
+template <typename TypeName>
+static inline size_t hex_decode_simd(char* buf,
+                                     size_t len,
+                                     const TypeName* src,
+                                     const size_t srcLen) {
+  return 0;
+}
+
+
+static inline size_t hex_decode_simd(char* buf,
+                                     size_t len,
+                                     const char* src,
+                                     const size_t srcLen) {
+  size_t i = 0;
+#if NODE_HAVE_SIMD_KERNELS
+  if (simd_features & kSimdSSE2)
+    hex_decode_sse2(buf, len, src, srcLen, &i);
+#endif
+  return i;
+}
+
+
 template <typename TypeName>
 size_t hex_decode(char* buf,
                   size_t len,
                   const TypeName* src,
                   const size_t srcLen) {
   size_t i;
-  for (i = 0; i < len && i * 2 + 1 < srcLen; ++i) {
+  for (i = hex_decode_simd(buf, len, src, srcLen);
+       i < len && i * 2 + 1 < srcLen;
+       ++i) {
     unsigned a = hex2bin(src[i * 2 + 0]);
     unsigned b = hex2bin(src[i * 2 + 1]);
     if (!~a || !~b)
@@ -356,6 +788,13 @@ size_t StringBytes::Write(Isolate* isolate,
     case BASE64:
       if (is_extern) {
         len = base64_decode(buf, buflen, data, extlen);
+      } else if (str->IsOneByte()) {
+        // Cheaper than String::Value and lets the vectorized decoder run.
+        const int n = str->Length();
+        char* const src = new char[n];
+        str->WriteOneByte(reinterpret_cast<uint8_t*>(src), 0, n, flags);
+        len = base64_decode(buf, buflen, src, n);
+        delete[] src;
       } else {
         String::Value value(str);
         len = base64_decode(buf, buflen, *value, value.length());
@@ -368,6 +807,13 @@ size_t StringBytes::Write(Isolate* isolate,
     case HEX:
       if (is_extern) {
         len = hex_decode(buf, buflen, data, extlen);
+      } else if (str->IsOneByte()) {
+        // See BASE64 above.
+        const int n = str->Length();
+        char* const src = new char[n];
+        str->WriteOneByte(reinterpret_cast<uint8_t*>(src), 0, n, flags);
+        len = hex_decode(buf, buflen, src, n);
+        delete[] src;
       } else {
         String::Value value(str);
         len = hex_decode(buf, buflen, *value, value.length());
@@ -514,6 +960,15 @@ static bool contains_non_ascii(const char* src, size_t len) {
     return contains_non_ascii_slow(src, len);
   }
 
+#if NODE_HAVE_SIMD_KERNELS
+  if (simd_features & kSimdSSE2) {
+    size_t i = 0;
+    if (contains_non_ascii_sse2(src, len, &i))
+      return true;
+    return contains_non_ascii_slow(src + i, len - i);
+  }
+#endif
+
   const unsigned bytes_per_word = sizeof(uintptr_t);
   const unsigned align_mask = bytes_per_word - 1;
   const unsigned unaligned = reinterpret_cast<uintptr_t>(src) & align_mask;
@@ -630,6 +1085,17 @@ static size_t base64_encode(const char* src,
   k = 0;
   n = slen / 3 * 3;
 
+#if NODE_HAVE_SIMD_KERNELS
+  size_t si = 0;
+  size_t sk = 0;
+  if (simd_features & kSimdAVX2)
+    base64_encode_avx2(src, slen, dst, &si, &sk);
+  if (simd_features & kSimdSSSE3)
+    base64_encode_ssse3(src, slen, dst, &si, &sk);
+  i = si;
+  k = sk;
+#endif
+
   while (i < n) {
     a = src[i + 0] & 0xff;
     b = src[i + 1] & 0xff;
@@ -675,7 +1141,15 @@ static size_t hex_encode(const char* src, size_t slen, char* dst, size_t dlen) {
       "not enough space provided for hex encode");
 
   dlen = slen * 2;
-  for (uint32_t i = 0, k = 0; k < dlen; i += 1, k += 2) {
+
+  size_t i = 0;
+  size_t k = 0;
+#if NODE_HAVE_SIMD_KERNELS
+  if (simd_features & kSimdSSE2)
+    hex_encode_sse2(src, slen, dst, &i, &k);
+#endif
+
+  for (; k < dlen; i += 1, k += 2) {
     static const char hex[] = "0123456789abcdef";
     uint8_t val = static_cast<uint8_t>(src[i]);
     dst[k + 0] = hex[val >> 4];
@@ -721,10 +1195,17 @@ Local<Value> StringBytes::Encode(Isolate* isolate,
       break;
 
     case UTF8:
-      val = String::NewFromUtf8(isolate,
-                                buf,
-                                String::kNormalString,
-                                buflen);
+      // Pure ASCII is valid one-byte data, no need to run the UTF-8 decoder.
+      if (contains_non_ascii(buf, buflen)) {
+        val = String::NewFromUtf8(isolate,
+                                  buf,
+                                  String::kNormalString,
+                                  buflen);
+      } else if (buflen < EXTERN_APEX) {
+        val = OneByteString(isolate, buf, buflen);
+      } else {
+        val = ExternOneByteString::NewFromCopy(isolate, buf, buflen);
+      }
       break;
 
     case BINARY:
@@ -91,6 +91,7 @@ class TimerWrap : public HandleWrap {
                    AsyncWrap::PROVIDER_TIMERWRAP) {
     int r = uv_timer_init(env->event_loop(), &handle_);
     assert(r == 0);
+    due_ = 0;
   }
 
   ~TimerWrap() {
@@ -104,6 +105,7 @@ class TimerWrap : public HandleWrap {
     int64_t timeout = args[0]->IntegerValue();
     int64_t repeat = args[1]->IntegerValue();
     int err = uv_timer_start(&wrap->handle_, OnTimeout, timeout, repeat);
+    wrap->due_ = uv_hrtime() + timeout * 1000000;
     args.GetReturnValue().Set(err);
   }
 
@@ -122,6 +124,7 @@ class TimerWrap : public HandleWrap {
     TimerWrap* wrap = Unwrap<TimerWrap>(args.Holder());
 
     int err = uv_timer_again(&wrap->handle_);
+    wrap->due_ = uv_hrtime() + uv_timer_get_repeat(&wrap->handle_) * 1000000;
     args.GetReturnValue().Set(err);
   }
 
@@ -147,6 +150,15 @@ class TimerWrap : public HandleWrap {
   static void OnTimeout(uv_timer_t* handle) {
     TimerWrap* wrap = static_cast<TimerWrap*>(handle->data);
     Environment* env = wrap->env();
+    Environment::LoopMetrics* loop_metrics = env->loop_metrics();
+    // Not uv_now(): the loop time is only updated once per iteration, so
+    // it doesn't see the time that earlier callbacks in this one took.
+    uint64_t now = uv_hrtime();
+    if (loop_metrics->enabled()) {
+      uint64_t late = now > wrap->due_ ? now - wrap->due_ : 0;
+      loop_metrics->OnTimer(late / 1000000);
+    }
+    wrap->due_ = now + uv_timer_get_repeat(handle) * 1000000;
     HandleScope handle_scope(env->isolate());
     Context::Scope context_scope(env->context());
     wrap->MakeCallback(kOnTimeout, 0, NULL);
@@ -161,6 +173,7 @@ class TimerWrap : public HandleWrap {
   }
 
   uv_timer_t handle_;
+  uint64_t due_;  // When the timer should fire, in uv_hrtime() time.
 };
 
 
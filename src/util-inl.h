@@ -115,6 +115,15 @@ TypeName* Unwrap(v8::Local<v8::Object> object) {
   return static_cast<TypeName*>(pointer);
 }
 
+inline int Log2Bucket(uint64_t value, int buckets) {
+  int bucket = 0;
+  while (value > 0 && bucket < buckets - 1) {
+    value >>= 1;
+    bucket += 1;
+  }
+  return bucket;
+}
+
 }  // namespace node
 
 #endif  // SRC_UTIL_INL_H_
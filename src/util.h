@@ -26,6 +26,7 @@
 
 #include <assert.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 namespace node {
@@ -115,6 +116,10 @@ inline void Wrap(v8::Local<v8::Object> object, void* pointer);
 template <typename TypeName>
 inline TypeName* Unwrap(v8::Local<v8::Object> object);
 
+// Histogram bucket for |value|: 0 for zero, n for [2^(n-1), 2^n), clamped
+// to |buckets| - 1 so that the last bucket is open ended.
+inline int Log2Bucket(uint64_t value, int buckets);
+
 class Utf8Value {
   public:
     explicit Utf8Value(v8::Handle<v8::Value> value);
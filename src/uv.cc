@@ -33,9 +33,11 @@ using v8::FunctionTemplate;
 using v8::Handle;
 using v8::HandleScope;
 using v8::Integer;
+using v8::Local;
 using v8::Object;
 using v8::String;
 using v8::Value;
+using v8::kExternalFloat64Array;
 
 
 void ErrName(const FunctionCallbackInfo<Value>& args) {
@@ -49,6 +51,18 @@ void ErrName(const FunctionCallbackInfo<Value>& args) {
 }
 
 
+void StartLoopMetrics(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args.GetIsolate());
+  env->loop_metrics()->Start(env->event_loop());
+}
+
+
+void StopLoopMetrics(const FunctionCallbackInfo<Value>& args) {
+  Environment* env = Environment::GetCurrent(args.GetIsolate());
+  env->loop_metrics()->Stop();
+}
+
+
 void Initialize(Handle<Object> target,
                 Handle<Value> unused,
                 Handle<Context> context) {
@@ -60,10 +74,82 @@ void Initialize(Handle<Object> target,
               Integer::New(env->isolate(), UV_ ## name));
   UV_ERRNO_MAP(V)
 #undef V
+
+  // The metrics are exposed as a Float64 array that JS reads directly,
+  // the kLoop* constants are its indices.
+  Environment::LoopMetrics* loop_metrics = env->loop_metrics();
+  Local<Object> fields = Object::New(env->isolate());
+  fields->SetIndexedPropertiesToExternalArrayData(loop_metrics->fields(),
+                                                  kExternalFloat64Array,
+                                                  loop_metrics->fields_count());
+  target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), "loopMetrics"), fields);
+#define V(name, value)                                                        \
+  target->Set(FIXED_ONE_BYTE_STRING(env->isolate(), name),                    \
+              Integer::New(env->isolate(), Environment::LoopMetrics::value));
+  V("kLoopIterations", kIterations)
+  V("kLoopEvents", kEvents)
+  V("kLoopIdleTime", kIdleTime)
+  V("kLoopBusyTime", kBusyTime)
+  V("kLoopTimerLateness", kTimerLateness)
+  V("kLoopTimerLatenessBuckets", kTimerLatenessBuckets)
+#undef V
+  NODE_SET_METHOD(target, "startLoopMetrics", StartLoopMetrics);
+  NODE_SET_METHOD(target, "stopLoopMetrics", StopLoopMetrics);
 }
 
 
 }  // namespace uv
+
+
+// The poll phase of the event loop sits between the prepare and the check
+// watchers.  It starts out idle, waiting for I/O, and turns busy when the
+// first callback runs, see LoopMetrics::OnCallback().  Everything outside
+// the poll phase (timers, immediates, close callbacks) counts as busy.
+void Environment::LoopMetrics::OnPrepare(uv_prepare_t* handle) {
+  LoopMetrics* self = ContainerOf(&LoopMetrics::prepare_handle_, handle);
+  self->fields_[kIterations] += 1;
+  self->Mark(kBusyTime);
+  self->in_poll_ = true;
+}
+
+
+void Environment::LoopMetrics::OnCheck(uv_check_t* handle) {
+  LoopMetrics* self = ContainerOf(&LoopMetrics::check_handle_, handle);
+  self->Mark(self->in_poll_ ? kIdleTime : kBusyTime);
+  self->in_poll_ = false;
+}
+
+
+void Environment::LoopMetrics::Start(uv_loop_t* loop) {
+  if (enabled_)
+    return;
+
+  if (initialized_ == false) {
+    uv_prepare_init(loop, &prepare_handle_);
+    uv_check_init(loop, &check_handle_);
+    uv_unref(reinterpret_cast<uv_handle_t*>(&prepare_handle_));
+    uv_unref(reinterpret_cast<uv_handle_t*>(&check_handle_));
+    initialized_ = true;
+  }
+
+  uv_prepare_start(&prepare_handle_, OnPrepare);
+  uv_check_start(&check_handle_, OnCheck);
+  mark_ = uv_hrtime();
+  in_poll_ = false;
+  enabled_ = true;
+}
+
+
+void Environment::LoopMetrics::Stop() {
+  if (enabled_ == false)
+    return;
+
+  uv_prepare_stop(&prepare_handle_);
+  uv_check_stop(&check_handle_);
+  enabled_ = false;
+}
+
+
 }  // namespace node
 
 NODE_MODULE_CONTEXT_AWARE_BUILTIN(uv, node::uv::Initialize)
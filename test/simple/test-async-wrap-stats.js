@@ -0,0 +1,86 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var fs = require('fs');
+var net = require('net');
+var binding = process.binding('async_wrap');
+
+var stats = binding.asyncStats;
+
+function field(provider, index) {
+  var base = binding.providers[provider] * binding.kAsyncFieldsPerProvider;
+  return stats[base + index];
+}
+
+function latencies(provider) {
+  var sum = 0;
+  for (var i = 0; i < binding.kAsyncLatencyBuckets; i++)
+    sum += field(provider, binding.kAsyncLatency + i);
+  return sum;
+}
+
+assert.equal(binding.providers.NONE, 0);
+assert.equal(binding.providers.TCPWRAP, 12);
+
+// Nothing is recorded until the stats are started.
+assert.equal(field('TCPWRAP', binding.kAsyncCreated), 0);
+
+binding.startAsyncStats();
+
+var server = net.createServer(function(conn) {
+  conn.end('hello');
+});
+
+server.listen(common.PORT, function() {
+  var conn = net.connect(common.PORT);
+  conn.resume();
+  conn.on('end', function() {
+    fs.stat(__filename, function(err) {
+      assert.ifError(err);
+      server.close();
+    });
+  });
+});
+
+process.on('exit', function() {
+  // The listen socket, the client and the server side of the connection.
+  assert.equal(field('TCPWRAP', binding.kAsyncCreated), 3);
+  assert.ok(field('TCPWRAP', binding.kAsyncCallbacks) > 0);
+  assert.equal(field('CONNECTWRAP', binding.kAsyncCreated), 1);
+  assert.equal(field('CONNECTWRAP', binding.kAsyncDestroyed), 1);
+  assert.equal(field('CONNECTWRAP', binding.kAsyncCallbacks), 1);
+  assert.equal(latencies('CONNECTWRAP'), 1);
+  assert.ok(field('CONNECTWRAP', binding.kAsyncLatencyTotal) > 0);
+
+  // fs requests.
+  var created = field('REQWRAP', binding.kAsyncCreated);
+  var destroyed = field('REQWRAP', binding.kAsyncDestroyed);
+  assert.ok(created >= 1);
+  assert.equal(created, destroyed);
+  assert.equal(latencies('REQWRAP'), field('REQWRAP', binding.kAsyncCallbacks));
+
+  binding.stopAsyncStats();
+  fs.statSync(__filename);
+  net.createServer();
+  assert.equal(field('REQWRAP', binding.kAsyncCreated), created);
+});
@@ -0,0 +1,80 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+var common = require('../common');
+var assert = require('assert');
+
+var list = [new Buffer('abc'), new Buffer(''), new Buffer('defg'), new Buffer('h')];
+
+// gather
+var b = new Buffer(10);
+b.fill('.');
+assert.equal(b.gather(list), 8);
+assert.equal(b.toString(), 'abcdefgh..');
+
+b.fill('.');
+assert.equal(b.gather(list, 3), 7);
+assert.equal(b.toString(), '...abcdefg');
+
+b.fill('.');
+assert.equal(b.gather(list, 10), 0);
+assert.equal(b.gather([]), 0);
+assert.equal(b.toString(), '..........');
+
+// gathering into a slice of one of the sources
+var c = new Buffer('0123456789');
+assert.equal(c.gather([c.slice(5)]), 5);
+assert.equal(c.toString(), '5678956789');
+
+// scatter
+var d = new Buffer('abcdefgh');
+var targets = [new Buffer(3), new Buffer(0), new Buffer(4), new Buffer(5)];
+targets[3].fill('.');
+assert.equal(d.scatter(targets), 8);
+assert.equal(targets[0].toString(), 'abc');
+assert.equal(targets[2].toString(), 'defg');
+assert.equal(targets[3].toString(), 'h....');
+
+assert.equal(d.scatter(targets, 6), 2);
+assert.equal(targets[0].toString('binary', 0, 2), 'gh');
+assert.equal(d.scatter(targets, 8), 0);
+
+// a round trip through scatter and gather is lossless
+var src = new Buffer(1000);
+for (var i = 0; i < src.length; ++i) src[i] = i & 255;
+var chunks = [];
+for (var i = 0; i < 1000; i += 37) chunks.push(new Buffer(37));
+assert.equal(src.scatter(chunks), src.length);
+var dst = new Buffer(src.length);
+assert.equal(dst.gather(chunks), src.length);
+assert.deepEqual(dst, src);
+assert.deepEqual(Buffer.concat(chunks, src.length), src);
+
+// argument validation
+assert.throws(function() { b.gather('abc'); }, TypeError);
+assert.throws(function() { b.gather([new Buffer('a'), 'b']); }, TypeError);
+assert.throws(function() { b.gather(list, -1); }, RangeError);
+assert.throws(function() { b.gather(list, 11); }, RangeError);
+assert.throws(function() { b.scatter({}); }, TypeError);
+assert.throws(function() { b.scatter([{}]); }, TypeError);
+assert.throws(function() { b.scatter(targets, 11); }, RangeError);
+assert.throws(function() { Buffer.concat([new Buffer('a'), 'b']); }, TypeError);
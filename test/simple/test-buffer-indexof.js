@@ -0,0 +1,111 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+
+var b = new Buffer('abcdef');
+var buf_a = new Buffer('a');
+var buf_bc = new Buffer('bc');
+var buf_f = new Buffer('f');
+var buf_z = new Buffer('z');
+var buf_empty = new Buffer('');
+
+assert.equal(b.indexOf('a'), 0);
+assert.equal(b.indexOf('a', 1), -1);
+assert.equal(b.indexOf('a', -1), -1);
+assert.equal(b.indexOf('a', -4), -1);
+assert.equal(b.indexOf('a', -b.length), 0);
+assert.equal(b.indexOf('a', NaN), 0);
+assert.equal(b.indexOf('a', -Infinity), 0);
+assert.equal(b.indexOf('a', Infinity), -1);
+assert.equal(b.indexOf('bc'), 1);
+assert.equal(b.indexOf('bc', 2), -1);
+assert.equal(b.indexOf('bc', -1), -1);
+assert.equal(b.indexOf('bc', -3), -1);
+assert.equal(b.indexOf('bc', -5), 1);
+assert.equal(b.indexOf('f'), b.length - 1);
+assert.equal(b.indexOf('z'), -1);
+assert.equal(b.indexOf('abcdefg'), -1);
+assert.equal(b.indexOf(''), 0);
+assert.equal(b.indexOf('', 3), 3);
+assert.equal(b.indexOf(buf_a), 0);
+assert.equal(b.indexOf(buf_a, 1), -1);
+assert.equal(b.indexOf(buf_bc), 1);
+assert.equal(b.indexOf(buf_bc, -5), 1);
+assert.equal(b.indexOf(buf_f), b.length - 1);
+assert.equal(b.indexOf(buf_z), -1);
+assert.equal(b.indexOf(buf_empty), 0);
+assert.equal(b.indexOf(0x61), 0);
+assert.equal(b.indexOf(0x61, 1), -1);
+assert.equal(b.indexOf(0x66, -1), b.length - 1);
+assert.equal(b.indexOf(0x66 + 256), b.length - 1);
+assert.equal(b.indexOf(0x7a), -1);
+
+// Strings are searched for as UTF-8.
+var utf8 = new Buffer('aéb€c');
+assert.equal(utf8.indexOf('é'), 1);
+assert.equal(utf8.indexOf('b'), 3);
+assert.equal(utf8.indexOf('€c'), 4);
+assert.equal(utf8.indexOf(new Buffer('€')), 4);
+
+// Works on slices.
+var slice = b.slice(2);
+assert.equal(slice.indexOf('c'), 0);
+assert.equal(slice.indexOf('a'), -1);
+
+// Long needles take a different code path than short ones.
+var boundary = '--------------------------boundary';
+var body = new Array(100).join('x') + boundary + 'payload' + boundary + '--';
+var buf = new Buffer(body);
+assert.equal(buf.indexOf(boundary), body.indexOf(boundary));
+assert.equal(buf.indexOf(boundary, 100), body.indexOf(boundary, 100));
+assert.equal(buf.indexOf(boundary + '--'), body.indexOf(boundary + '--'));
+assert.equal(buf.indexOf(boundary + 'x'), -1);
+assert.equal(buf.indexOf(new Buffer(boundary), 200), -1);
+
+// Compare against String#indexOf on pseudo-random ASCII input.
+var alphabet = 'abcab';
+var haystack = '';
+var seed = 1;
+for (var i = 0; i < 2000; ++i) {
+  seed = (seed * 75 + 74) % 65537;
+  haystack += alphabet[seed % alphabet.length];
+}
+var hbuf = new Buffer(haystack);
+for (var len = 1; len < 20; ++len) {
+  for (var start = 0; start < 50; start += 7) {
+    var needle = haystack.substr(start * 13, len) + 'c';
+    for (var off = 0; off < 100; off += 33) {
+      assert.equal(hbuf.indexOf(needle, off), haystack.indexOf(needle, off));
+    }
+  }
+}
+
+assert.throws(function() {
+  b.indexOf(function() { });
+});
+assert.throws(function() {
+  b.indexOf({});
+});
+assert.throws(function() {
+  b.indexOf([]);
+});
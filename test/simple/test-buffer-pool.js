@@ -0,0 +1,84 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Flags: --expose_gc
+
+var common = require('../common');
+var assert = require('assert');
+var smalloc = require('smalloc');
+
+assert(typeof gc === 'function', 'Run this test with --expose_gc.');
+
+function usedChunks(chunkSize) {
+  var classes = smalloc.poolStats().sizeClasses;
+  for (var i = 0; i < classes.length; i++)
+    if (classes[i].chunkSize === chunkSize)
+      return classes[i].used;
+  return 0;
+}
+
+var stats = smalloc.poolStats();
+assert.equal(stats.poolSize, Buffer.poolSize);
+assert.ok(stats.usedBytes <= stats.totalBytes);
+assert.ok(Array.isArray(stats.sizeClasses));
+
+// small buffers are rounded up to a power of two chunk
+gc();
+var before = usedChunks(32);
+var retained = [];
+for (var i = 0; i < 1000; i++) {
+  var b = new Buffer(20);
+  b.fill(i & 255);
+  if (i % 100 === 0) retained.push(b);
+}
+assert.ok(usedChunks(32) >= before + retained.length);
+
+// unreferenced buffers give their chunk back, the retained ones don't pin
+// their neighbours
+b = null;
+gc();
+assert.equal(usedChunks(32), before + retained.length);
+for (var i = 0; i < retained.length; i++) {
+  assert.equal(retained[i].length, 20);
+  assert.equal(retained[i][19], (i * 100) & 255);
+}
+
+var stats = smalloc.poolStats();
+var classes = stats.sizeClasses;
+for (var i = 0; i < classes.length; i++) {
+  assert.ok(classes[i].used <= classes[i].chunks);
+  assert.equal(classes[i].chunkSize & (classes[i].chunkSize - 1), 0);
+}
+
+// slices keep the buffer they were cut from alive
+var s = new Buffer(40).slice(1, 3);
+gc();
+assert.equal(s.parent.length, 40);
+
+// the pool size is tunable, bigger buffers go straight to malloc()
+var poolSize = Buffer.poolSize;
+Buffer.poolSize = 64 * 1024;
+var big = new Buffer(16 * 1024);
+assert.equal(smalloc.poolStats().poolSize, 64 * 1024);
+assert.equal(usedChunks(16 * 1024), 1);
+Buffer.poolSize = poolSize;
+var big2 = new Buffer(16 * 1024);
+assert.equal(usedChunks(16 * 1024), 1);
@@ -273,12 +273,12 @@ for (var j = 0; j < 100; j++) {
 }
 
 
-// make sure only top level parent propagates from allocPool
+// make sure only top level parent propagates from a pooled instance
 var b = new Buffer(5);
 var c = b.slice(0, 4);
 var d = c.slice(0, 2);
-assert.equal(b.parent, c.parent);
-assert.equal(b.parent, d.parent);
+assert.equal(b, c.parent);
+assert.equal(b, d.parent);
 
 // also from a non-pooled instance
 var b = new SlowBuffer(5);
@@ -509,6 +509,37 @@ for (var i = 0; i < segments.length; ++i) {
 }
 assert.equal(b.toString('binary', 0, pos), 'Madness?! This is node.js!');
 
+// Inputs long enough to exercise the vectorized base64 and hex code paths.
+(function() {
+  var raw = new Buffer(1027);
+  for (var i = 0; i < raw.length; ++i) raw[i] = (i * 131 + 7) & 255;
+
+  for (var len = 0; len < 100; ++len) {
+    var b64 = raw.slice(0, len).toString('base64');
+    assert.deepEqual(new Buffer(b64, 'base64'), raw.slice(0, len));
+    var hex = raw.slice(0, len).toString('hex');
+    assert.deepEqual(new Buffer(hex, 'hex'), raw.slice(0, len));
+  }
+
+  var b64 = raw.toString('base64');
+  assert.deepEqual(new Buffer(b64, 'base64'), raw);
+  assert.deepEqual(new Buffer(b64.replace(/\//g, '_').replace(/\+/g, '-'),
+                              'base64'), raw);
+  assert.deepEqual(new Buffer(b64.replace(/.{76}/g, '$&\r\n'), 'base64'), raw);
+  assert.deepEqual(new Buffer(b64.replace(/.{5}/g, '$& '), 'base64'), raw);
+
+  var hex = raw.toString('hex');
+  assert.equal(hex.length, 2 * raw.length);
+  assert.deepEqual(new Buffer(hex, 'hex'), raw);
+  assert.deepEqual(new Buffer(hex.toUpperCase(), 'hex'), raw);
+
+  // Decoding stops at the first invalid hex digit.
+  var dst = new Buffer(raw.length);
+  var bad = hex.slice(0, 80) + 'zz' + hex.slice(82);
+  assert.equal(dst.write(bad, 0, 'hex'), 40);
+  assert.deepEqual(dst.slice(0, 40), raw.slice(0, 40));
+})();
+
 // Creating buffers larger than pool size.
 var l = Buffer.poolSize + 5;
 var s = '';
@@ -0,0 +1,116 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var fork = require('child_process').fork;
+var net = require('net');
+
+if (process.argv[2] === 'child') {
+  assert.equal(process.env.NODE_CHANNEL_FRAMING, undefined);
+
+  // Echo everything back, Buffers get a byte added so that it's clear they
+  // came through as Buffers.
+  process.on('message', function(m, handle) {
+    if (handle) {
+      handle.on('connection', function(conn) {
+        conn.end('child');
+        handle.close();
+      });
+      process.send({ cmd: 'listening' });
+      return;
+    }
+    if (Buffer.isBuffer(m))
+      process.send(Buffer.concat([m, new Buffer([42])]));
+    else
+      process.send(m);
+  });
+  return;
+}
+
+assert.throws(function() {
+  fork(__filename, ['child'], { framing: 'xml' });
+}, TypeError);
+
+var child = fork(__filename, ['child'], { framing: 'binary' });
+
+// A big Buffer takes many reads, the small messages arrive several in one.
+var big = new Buffer(8 * 1024 * 1024 + 3);
+for (var i = 0; i < big.length; i++)
+  big[i] = i % 253;
+
+var sent = [
+  { hello: 'world', unicode: 'é中😀' },
+  new Buffer(0),
+  big,
+  'a string',
+  [1, 2, 3],
+  null
+];
+for (var i = 0; i < 100; i++)
+  sent.push({ n: i });
+
+sent.forEach(function(m) {
+  child.send(m);
+});
+
+var received = [];
+child.on('message', function(m) {
+  if (m && m.cmd === 'listening')
+    return connect();
+
+  var expected = sent[received.length];
+  if (Buffer.isBuffer(expected)) {
+    assert(Buffer.isBuffer(m));
+    assert.equal(m.length, expected.length + 1);
+    assert.equal(m[m.length - 1], 42);
+    assert.equal(m.slice(0, -1).toString('hex'), expected.toString('hex'));
+  } else {
+    assert.deepEqual(m, expected);
+  }
+  received.push(m);
+
+  // Handles are still sent along with messages.
+  if (received.length === sent.length) {
+    var server = net.createServer();
+    server.listen(common.PORT, function() {
+      child.send('server', server);
+      server.close();
+    });
+  }
+});
+
+var gotReply = false;
+function connect() {
+  var chunks = [];
+  net.connect(common.PORT).on('data', function(chunk) {
+    chunks.push(chunk);
+  }).on('end', function() {
+    assert.equal(Buffer.concat(chunks).toString(), 'child');
+    gotReply = true;
+    child.disconnect();
+  });
+}
+
+process.on('exit', function() {
+  assert.equal(received.length, sent.length);
+  assert(gotReply);
+});
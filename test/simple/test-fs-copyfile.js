@@ -0,0 +1,112 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var path = require('path');
+var fs = require('fs');
+
+var src = path.join(common.tmpDir, 'copyfile-src');
+var dest = path.join(common.tmpDir, 'copyfile-dest');
+var missing = path.join(common.tmpDir, 'copyfile-does-not-exist');
+
+var data = new Buffer(3 * 65536 + 17);
+for (var i = 0; i < data.length; i++) data[i] = i % 253;
+fs.writeFileSync(src, data);
+if (process.platform !== 'win32') fs.chmodSync(src, '0640');
+try { fs.unlinkSync(dest); } catch (e) {}
+
+fs.copyFileSync(src, dest);
+assert.deepEqual(fs.readFileSync(dest), data);
+if (process.platform !== 'win32')
+  assert.equal(fs.statSync(dest).mode & 511, parseInt('0640', 8));
+
+// Overwrites by default, 'wx' refuses to.
+fs.writeFileSync(dest, 'overwrite me, but make it a lot longer than before');
+fs.copyFileSync(src, dest);
+assert.deepEqual(fs.readFileSync(dest), data);
+assert.throws(function() {
+  fs.copyFileSync(src, dest, 'wx');
+}, function(e) {
+  return e.code === 'EEXIST' && e.path === dest;
+});
+
+// 'a' appends to what's already there.
+fs.writeFileSync(dest, 'head');
+fs.copyFileSync(src, dest, 'a');
+assert.deepEqual(fs.readFileSync(dest),
+                 Buffer.concat([new Buffer('head'), data]));
+
+// Empty files and files that lie about their size.
+fs.writeFileSync(src, '');
+fs.copyFileSync(src, dest);
+assert.equal(fs.readFileSync(dest).length, 0);
+if (process.platform === 'linux') {
+  fs.copyFileSync('/proc/self/status', dest);
+  assert(/^Name:/.test(fs.readFileSync(dest, 'utf8')));
+  // sysfs files report a size of one page, whatever they hold.
+  var sysfsFile = '/sys/devices/system/cpu/online';
+  if (fs.existsSync(sysfsFile)) {
+    fs.copyFileSync(sysfsFile, dest);
+    assert.deepEqual(fs.readFileSync(dest), fs.readFileSync(sysfsFile));
+    assert(fs.readFileSync(dest).length > 0);
+  }
+}
+
+assert.throws(function() {
+  fs.copyFileSync(missing, dest);
+}, function(e) {
+  return e.code === 'ENOENT' && e.path === missing;
+});
+
+var callbacks = 0;
+
+fs.writeFileSync(src, data);
+fs.copyFile(src, dest, function(err) {
+  assert.ifError(err);
+  assert.deepEqual(fs.readFileSync(dest), data);
+  callbacks++;
+
+  fs.copyFile(dest, dest, function(err) {
+    assert.equal(err.code, 'EINVAL');
+    assert.deepEqual(fs.readFileSync(dest), data);
+    callbacks++;
+  });
+});
+
+var appended = path.join(common.tmpDir, 'copyfile-appended');
+fs.writeFileSync(appended, 'head');
+fs.copyFile(src, appended, 'a', function(err) {
+  assert.ifError(err);
+  assert.deepEqual(fs.readFileSync(appended),
+                   Buffer.concat([new Buffer('head'), data]));
+  callbacks++;
+});
+
+fs.copyFile(missing, dest, function(err) {
+  assert.equal(err.code, 'ENOENT');
+  assert.equal(err.path, missing);
+  callbacks++;
+});
+
+process.on('exit', function() {
+  assert.equal(callbacks, 4);
+});
@@ -0,0 +1,131 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Flags: --expose_gc
+
+var common = require('../common');
+var assert = require('assert');
+var smalloc = require('smalloc');
+var path = require('path');
+var fs = require('fs');
+
+assert(typeof gc === 'function', 'Run this test with --expose_gc.');
+
+function sizeClass(chunkSize) {
+  var classes = smalloc.readPoolStats().sizeClasses;
+  for (var i = 0; i < classes.length; i++)
+    if (classes[i].chunkSize === chunkSize)
+      return classes[i];
+  return { chunkSize: chunkSize, chunks: 0, used: 0, free: 0 };
+}
+
+var stats = smalloc.readPoolStats();
+assert.equal(stats.limit, 4 * 1024 * 1024);
+assert.ok(stats.usedBytes <= stats.totalBytes);
+assert.equal(stats.freeBytes, stats.totalBytes - stats.usedBytes);
+
+assert.throws(function() {
+  smalloc.setReadPoolLimit(-1);
+}, RangeError);
+
+// 10 full 64 KB reads and a 100 byte tail.
+var filename = path.join(common.tmpDir, 'read-stream-pool.bin');
+var data = new Buffer(10 * 64 * 1024 + 100);
+for (var i = 0; i < data.length; i++)
+  data[i] = i % 251;
+fs.writeFileSync(filename, data);
+
+var retained = [];
+var tail = null;
+var ended = false;
+
+fs.createReadStream(filename).on('data', function(chunk) {
+  if (chunk.length === 64 * 1024) {
+    if (retained.length < 3)
+      retained.push(chunk);
+  } else {
+    tail = chunk;
+  }
+}).on('end', function() {
+  ended = true;
+  setImmediate(afterEnd);
+});
+
+function afterEnd() {
+  // The tail was copied into a Buffer of its own.
+  assert.equal(tail.length, 100);
+  assert.equal(tail.parent, undefined);
+  for (var i = 0; i < tail.length; i++)
+    assert.equal(tail[i], (10 * 64 * 1024 + i) % 251);
+
+  // Only the chunks that are still referenced are in use, the others went
+  // back to the pool.
+  gc();
+  var sc = sizeClass(64 * 1024);
+  assert.equal(sc.used, retained.length);
+  assert.equal(sc.free, sc.chunks - sc.used);
+  for (var i = 0; i < retained.length; i++)
+    assert.equal(retained[i][0], (i * 64 * 1024) % 251);
+
+  // Reading the file again reuses the free chunks.
+  var chunks = sc.chunks;
+  var received = [];
+  fs.createReadStream(filename).on('data', function(chunk) {
+    received.push(chunk);
+  }).on('end', function() {
+    assert.ok(sizeClass(64 * 1024).chunks < chunks + 10);
+    assert.equal(Buffer.concat(received).toString('hex'),
+                 data.toString('hex'));
+    received = null;
+    setImmediate(customSize);
+  });
+}
+
+// The chunk size follows highWaterMark and the limit trims the free lists.
+function customSize() {
+  var stream = fs.createReadStream(filename, { highWaterMark: 5000 });
+  stream.on('data', function(chunk) {
+    assert.ok(chunk.length <= 5000);
+  });
+  stream.on('end', function() {
+    setImmediate(function() {
+      gc();
+      assert.ok(sizeClass(8 * 1024).chunks > 0);
+      smalloc.setReadPoolLimit(0);
+      var stats = smalloc.readPoolStats();
+      assert.equal(stats.limit, 0);
+      assert.equal(stats.freeBytes, 0);
+      assert.equal(stats.totalBytes, stats.usedBytes);
+      assert.equal(sizeClass(8 * 1024).chunks, 0);
+      retained = null;
+      gc();
+      assert.equal(smalloc.readPoolStats().totalBytes, 0);
+      smalloc.setReadPoolLimit(4 * 1024 * 1024);
+      done = true;
+    });
+  });
+}
+
+var done = false;
+process.on('exit', function() {
+  assert(ended);
+  assert(done);
+});
@@ -0,0 +1,83 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var path = require('path');
+var fs = require('fs');
+
+var missing = path.join(common.fixturesDir, 'does-not-exist');
+
+// More paths than fit in a single batch.
+var paths = [];
+for (var i = 0; i < 2500; i++)
+  paths.push(i % 3 === 2 ? missing : i % 3 ? common.fixturesDir : __filename);
+
+var callbacks = 0;
+
+fs.statMany(paths, function(err, results) {
+  assert.equal(err, null);
+  assert.equal(results.length, paths.length);
+
+  var file = fs.statSync(__filename);
+  var dir = fs.statSync(common.fixturesDir);
+
+  results.forEach(function(result, i) {
+    if (paths[i] === missing) {
+      assert(result instanceof Error);
+      assert.equal(result.code, 'ENOENT');
+      assert.equal(result.path, missing);
+      return;
+    }
+    assert(result instanceof fs.Stats);
+    var expected = paths[i] === __filename ? file : dir;
+    assert.equal(result.ino, expected.ino);
+    assert.equal(result.size, expected.size);
+    assert.equal(result.isDirectory(), expected.isDirectory());
+    // Not all platforms have sub-second resolution.
+    assert.equal(Math.floor(result.mtime / 1000),
+                 Math.floor(expected.mtime / 1000));
+  });
+  callbacks++;
+});
+
+fs.statMany([], function(err, results) {
+  assert.equal(err, null);
+  assert.deepEqual(results, []);
+  callbacks++;
+});
+
+fs.statMany(['foo\u0000bar'], function(err) {
+  assert(/null bytes/.test(err.message));
+  callbacks++;
+});
+
+assert.throws(function() {
+  fs.statMany('foo', function() {});
+}, TypeError);
+
+assert.throws(function() {
+  fs.statMany([42], function() {});
+}, TypeError);
+
+process.on('exit', function() {
+  assert.equal(callbacks, 3);
+});
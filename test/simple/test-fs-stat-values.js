@@ -0,0 +1,68 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var fs = require('fs');
+
+var binding = process.binding('fs');
+
+// The binding fills a caller provided Float64Array instead of returning a
+// fs.Stats object, sync and async.
+var values = new Float64Array(14);
+assert.equal(binding.stat(__filename, undefined, values), undefined);
+
+var stats = fs.statSync(__filename);
+assert.equal(values[1], stats.mode);
+assert.equal(values[7], stats.ino);
+assert.equal(values[8], stats.size);
+assert.equal(values[11], stats.mtime.getTime());
+
+// Too small, falls back to a fs.Stats object.
+assert(binding.stat(__filename, undefined, new Float64Array(4)) instanceof
+       fs.Stats);
+
+// Works with views that don't start at the beginning of the buffer.
+var view = new Float64Array(new ArrayBuffer(8 * 16), 16);
+binding.fstat(0, undefined, view);
+assert.equal(view[1], fs.fstatSync(0).mode);
+
+var called = 0;
+var async = new Float64Array(14);
+binding.lstat(__filename, function(err, arg) {
+  assert.equal(err, null);
+  assert.equal(arg, undefined);
+  assert.equal(async[8], stats.size);
+  called++;
+}, async);
+
+// fs.stat() results must not be clobbered by sync calls in between.
+fs.stat(__filename, function(err, st) {
+  assert.ifError(err);
+  assert.equal(st.size, stats.size);
+  assert.equal(st.mtime.getTime(), stats.mtime.getTime());
+  called++;
+});
+fs.statSync(common.fixturesDir);
+
+process.on('exit', function() {
+  assert.equal(called, 2);
+});
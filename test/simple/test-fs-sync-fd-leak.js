@@ -23,6 +23,12 @@ var common = require('../common');
 var assert = require('assert');
 var fs = require('fs');
 
+// The native single-job readFile/writeFile never expose the descriptor;
+// disable them so the JS implementation used on Windows is exercised.
+var binding = process.binding('fs');
+delete binding.readFile;
+delete binding.writeFile;
+
 // ensure that (read|write|append)FileSync() closes the file descriptor
 fs.openSync = function() {
   return 42;
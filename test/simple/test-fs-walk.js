@@ -0,0 +1,140 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var constants = require('constants');
+var path = require('path');
+var fs = require('fs');
+
+var root = path.join(common.tmpDir, 'walk');
+
+function rmrf(p) {
+  try {
+    if (fs.lstatSync(p).isDirectory()) {
+      fs.readdirSync(p).forEach(function(name) {
+        rmrf(path.join(p, name));
+      });
+      fs.rmdirSync(p);
+    } else {
+      fs.unlinkSync(p);
+    }
+  } catch (e) {
+    if (e.code !== 'ENOENT') throw e;
+  }
+}
+
+// root/
+//   a/
+//     b/
+//       c/file
+//     file-0 .. file-1499
+//   skip/file
+//   link -> a
+//   file
+rmrf(root);
+fs.mkdirSync(root);
+fs.mkdirSync(path.join(root, 'a'));
+fs.mkdirSync(path.join(root, 'a', 'b'));
+fs.mkdirSync(path.join(root, 'a', 'b', 'c'));
+fs.writeFileSync(path.join(root, 'a', 'b', 'c', 'file'), '');
+for (var i = 0; i < 1500; i++)
+  fs.writeFileSync(path.join(root, 'a', 'file-' + i), '');
+fs.mkdirSync(path.join(root, 'skip'));
+fs.writeFileSync(path.join(root, 'skip', 'file'), '');
+fs.writeFileSync(path.join(root, 'file'), '');
+if (process.platform !== 'win32')
+  fs.symlinkSync('a', path.join(root, 'link'));
+
+function walk(options, cb) {
+  var entries = {};
+  var batches = 0;
+  fs.walk(root, options).on('entries', function(paths, types) {
+    assert.equal(paths.length, types.length);
+    paths.forEach(function(p, i) {
+      p = p.split(path.sep).join('/');
+      assert(!(p in entries), 'duplicate entry ' + p);
+      entries[p] = types[i];
+    });
+    batches++;
+  }).on('end', function() {
+    cb(entries, batches);
+  });
+}
+
+var callbacks = 0;
+
+walk({ exclude: ['skip'] }, function(entries, batches) {
+  assert.equal(entries['a'], constants.S_IFDIR);
+  assert.equal(entries['a/b/c'], constants.S_IFDIR);
+  assert.equal(entries['a/b/c/file'], constants.S_IFREG);
+  assert.equal(entries['a/file-1499'], constants.S_IFREG);
+  assert.equal(entries['file'], constants.S_IFREG);
+  assert(!('skip' in entries));
+  assert(!('skip/file' in entries));
+  if (process.platform !== 'win32') {
+    // Reported but not followed.
+    assert.equal(entries['link'], constants.S_IFLNK);
+    assert(!('link/file-0' in entries));
+  }
+  assert(batches > 1);
+  callbacks++;
+});
+
+walk({ depth: 1 }, function(entries) {
+  assert.equal(entries['a/b'], constants.S_IFDIR);
+  assert.equal(entries['skip/file'], constants.S_IFREG);
+  assert(!('a/b/c' in entries));
+  callbacks++;
+});
+
+fs.walk(path.join(root, 'does-not-exist')).on('error', function(err) {
+  assert.equal(err.code, 'ENOENT');
+  callbacks++;
+}).on('end', assert.fail);
+
+// Stopping from within the first batch means no more events.
+fs.walk(root).on('entries', function() {
+  this.stop();
+  callbacks++;
+}).on('end', assert.fail);
+
+fs.readdir(root, { types: true }, function(err, names, types) {
+  assert.ifError(err);
+  assert.deepEqual(names.slice().sort(), fs.readdirSync(root).sort());
+  assert.equal(types[names.indexOf('a')], constants.S_IFDIR);
+  assert.equal(types[names.indexOf('file')], constants.S_IFREG);
+  callbacks++;
+});
+
+fs.readdir(path.join(root, 'file'), { types: true }, function(err) {
+  assert.equal(err.code, 'ENOTDIR');
+  callbacks++;
+});
+
+assert.throws(function() {
+  fs.walk(root, { depth: -1 });
+}, TypeError);
+
+process.on('exit', function() {
+  assert.equal(callbacks, 6);
+  rmrf(root);
+});
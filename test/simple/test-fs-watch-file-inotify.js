@@ -0,0 +1,187 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var path = require('path');
+var fs = require('fs');
+
+if (process.platform !== 'linux') {
+  console.error('Skipping: inotify-backed watchFile is Linux only.');
+  process.exit(0);
+}
+
+// A polled file would only be seen on the next poll, up to |interval| later.
+// inotify reports the first change after a quiet interval right away, and
+// the changes within an interval together at the end of it.
+var interval = 2000;
+var file = path.join(common.tmpDir, 'watch-file-inotify.txt');
+var dir = path.join(common.tmpDir, 'watch-file-inotify');
+var nested = path.join(dir, 'nested.txt');
+// A release layout where |current| is a symlink that gets pointed at the
+// next release, and a directory whose parent is renamed.
+var releases = path.join(common.tmpDir, 'watch-file-inotify-releases');
+var current = path.join(releases, 'current');
+var releaseFile = path.join(current, 'file.txt');
+var moved = path.join(common.tmpDir, 'watch-file-inotify-moved');
+var movedFile = path.join(moved, 'sub', 'file.txt');
+
+function rmrf(p) {
+  var st;
+  try { st = fs.lstatSync(p); } catch (e) { return; }
+  if (st.isDirectory()) {
+    fs.readdirSync(p).forEach(function(name) {
+      rmrf(path.join(p, name));
+    });
+    fs.rmdirSync(p);
+  } else {
+    fs.unlinkSync(p);
+  }
+}
+
+try { fs.unlinkSync(file); } catch (e) { }
+try { fs.unlinkSync(nested); } catch (e) { }
+try { fs.rmdirSync(dir); } catch (e) { }
+rmrf(releases);
+rmrf(moved);
+rmrf(moved + '.old');
+
+fs.mkdirSync(releases);
+fs.mkdirSync(path.join(releases, 'r1'));
+fs.mkdirSync(path.join(releases, 'r2'));
+fs.writeFileSync(path.join(releases, 'r1', 'file.txt'), 'r1');
+fs.writeFileSync(path.join(releases, 'r2', 'file.txt'), 'release');
+fs.symlinkSync('r1', current);
+fs.mkdirSync(moved);
+fs.mkdirSync(path.join(moved, 'sub'));
+fs.writeFileSync(movedFile, 'old');
+
+var changes = [];
+fs.watchFile(file, { interval: interval }, function(curr, prev) {
+  changes.push([curr, prev]);
+});
+
+// A file that is watched before its directory exists is polled until the
+// directory shows up.
+var nestedChanges = 0;
+fs.watchFile(nested, { interval: 100 }, function(curr, prev) {
+  // Like with polling, a missing file is reported right away.
+  if (curr.nlink === 0)
+    return;
+  assert.equal(prev.size, 0);
+  assert.equal(curr.size, 6);
+  nestedChanges++;
+  fs.unwatchFile(nested);
+});
+
+// Both are still reported like with polling.
+var releaseChanges = [];
+fs.watchFile(releaseFile, { interval: 100 }, function(curr, prev) {
+  releaseChanges.push([prev.size, curr.size]);
+});
+var movedChanges = [];
+fs.watchFile(movedFile, { interval: 100 }, function(curr, prev) {
+  movedChanges.push([prev.size, curr.size]);
+});
+
+// Each step runs the given number of milliseconds after the previous one.
+// The first stat() starts an interval, so the first step waits it out.
+var steps = [
+  [interval + 500, function() {
+    fs.symlinkSync('r2', current + '.tmp');
+    fs.renameSync(current + '.tmp', current);
+    fs.renameSync(moved, moved + '.old');
+    fs.mkdirSync(moved);
+    fs.mkdirSync(path.join(moved, 'sub'));
+    fs.writeFileSync(movedFile, 'replaced');
+
+    // The missing file was reported.
+    assert.equal(changes.length, 1);
+    assert.equal(changes[0][0].nlink, 0);
+    changes = [];
+    fs.writeFileSync(file, 'a');
+    fs.mkdirSync(dir);
+    fs.writeFileSync(nested, 'nested');
+  }],
+  [300, function() {
+    // Reported right away, long before the next poll would have seen it.
+    assert.equal(changes.length, 1);
+    assert.equal(changes[0][0].size, 1);
+    assert.equal(changes[0][1].size, 0);
+    changes = [];
+    // A busy file, like a log, is stat()ed once per interval, not once per
+    // write.
+    var appends = 0;
+    var timer = setInterval(function() {
+      fs.appendFileSync(file, 'b');
+      if (++appends === 50)
+        clearInterval(timer);
+    }, 20);
+  }],
+  [interval + 1500, function() {
+    assert.ok(changes.length >= 1 && changes.length <= 2, changes.length);
+    var last = changes[changes.length - 1];
+    assert.equal(last[0].size, 51);
+    changes = [];
+    // Replacing the file with a rename, within the last stat()'s interval.
+    fs.writeFileSync(file + '.tmp', 'renamed!');
+    fs.renameSync(file + '.tmp', file);
+  }],
+  [interval + 500, function() {
+    assert.equal(changes.length, 1);
+    assert.equal(changes[0][0].size, 8);
+    assert.equal(changes[0][1].size, 51);
+    fs.unlinkSync(file);
+  }],
+  [300, function() {
+    assert.equal(changes.length, 2);
+    assert.equal(changes[1][0].size, 0);
+    assert.equal(changes[1][0].nlink, 0);
+    assert.equal(changes[1][1].size, 8);
+    fs.unwatchFile(file);
+    fs.writeFileSync(file, 'unwatched');
+  }],
+  [500, function() {
+    assert.equal(changes.length, 2);
+    assert.equal(nestedChanges, 1);
+    assert.deepEqual(releaseChanges, [[2, 7]]);
+    assert.deepEqual(movedChanges, [[3, 8]]);
+    fs.unwatchFile(releaseFile);
+    fs.unwatchFile(movedFile);
+  }]
+];
+
+var step = 0;
+setTimeout(function next() {
+  steps[step++][1]();
+  if (step < steps.length)
+    setTimeout(next, steps[step][0]);
+}, steps[0][0]);
+
+process.on('exit', function() {
+  assert.equal(step, steps.length);
+  fs.unlinkSync(file);
+  fs.unlinkSync(nested);
+  fs.rmdirSync(dir);
+  rmrf(releases);
+  rmrf(moved);
+  rmrf(moved + '.old');
+});
@@ -0,0 +1,124 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var path = require('path');
+var fs = require('fs');
+
+if (process.platform !== 'linux') {
+  console.error('Skipping: recursive inotify watches are Linux only.');
+  process.exit(0);
+}
+
+var root = path.join(common.tmpDir, 'watch-tree');
+
+function rmrf(p) {
+  try {
+    fs.readdirSync(p).forEach(function(name) {
+      rmrf(path.join(p, name));
+    });
+    fs.rmdirSync(p);
+  } catch (e) {
+    try { fs.unlinkSync(p); } catch (e) { }
+  }
+}
+
+rmrf(root);
+fs.mkdirSync(root);
+fs.mkdirSync(path.join(root, 'a'));
+fs.mkdirSync(path.join(root, 'a', 'b'));
+
+assert.throws(function() {
+  fs.watch(root, { recursive: true, coalesce: -1 });
+}, TypeError);
+
+var batches = [];
+var seen = {};
+var watcher = fs.watch(root, { recursive: true, coalesce: 50 });
+
+watcher.on('changes', function(events, filenames) {
+  assert.equal(events.length, filenames.length);
+  batches.push(filenames);
+});
+
+watcher.on('change', function(event, filename) {
+  assert.ok(event === 'change' || event === 'rename');
+  seen[filename] = (seen[filename] || 0) + 1;
+});
+
+var steps = [
+  // A burst of writes to a file deep in the tree is a single change.
+  function() {
+    var file = path.join(root, 'a', 'b', 'file.txt');
+    for (var i = 0; i < 10; i++)
+      fs.writeFileSync(file, 'x' + i);
+  },
+  function() {
+    assert.equal(seen['a/b/file.txt'], 1);
+    assert.equal(batches.length, 1);
+  },
+  // Directories that are created are watched, also what was put in them
+  // before the watch was added is reported.
+  function() {
+    fs.mkdirSync(path.join(root, 'c'));
+    fs.writeFileSync(path.join(root, 'c', 'early.txt'), 'early');
+  },
+  function() {
+    assert.ok(seen['c']);
+    assert.ok(seen['c/early.txt']);
+    fs.writeFileSync(path.join(root, 'c', 'late.txt'), 'late');
+  },
+  function() {
+    assert.ok(seen['c/late.txt']);
+  },
+  // Renamed directories are reported under their new name.
+  function() {
+    fs.renameSync(path.join(root, 'a'), path.join(root, 'e'));
+  },
+  function() {
+    assert.ok(seen['a']);
+    assert.ok(seen['e']);
+    seen = {};
+    fs.writeFileSync(path.join(root, 'e', 'b', 'moved.txt'), 'moved');
+  },
+  function() {
+    assert.ok(seen['e/b/moved.txt']);
+    assert.ok(!seen['a/b/moved.txt']);
+    watcher.close();
+    fs.writeFileSync(path.join(root, 'e', 'b', 'closed.txt'), 'closed');
+  },
+  function() {
+    assert.ok(!seen['e/b/closed.txt']);
+  }
+];
+
+var step = 0;
+(function next() {
+  steps[step++]();
+  if (step < steps.length)
+    setTimeout(next, 200);
+})();
+
+process.on('exit', function() {
+  assert.equal(step, steps.length);
+  rmrf(root);
+});
@@ -0,0 +1,94 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var path = require('path');
+var fs = require('fs');
+
+var filename = path.join(common.tmpDir, 'whole-file.txt');
+var big = new Buffer(1024 * 1024 + 7);
+for (var i = 0; i < big.length; i++) big[i] = i % 251;
+
+// Empty file.
+fs.writeFileSync(filename, '');
+assert.equal(fs.readFileSync(filename).length, 0);
+assert.equal(fs.readFileSync(filename, 'utf8'), '');
+
+// Larger than the initial read chunk, not a multiple of it.
+fs.writeFileSync(filename, big);
+assert.deepEqual(fs.readFileSync(filename), big);
+
+// Append flag.
+fs.writeFileSync(filename, 'abc');
+fs.writeFileSync(filename, 'def', { flag: 'a', fsync: true });
+assert.equal(fs.readFileSync(filename, 'utf8'), 'abcdef');
+
+// Files that report a size of zero but aren't empty.
+if (process.platform === 'linux') {
+  assert(/^Name:/.test(fs.readFileSync('/proc/self/status', 'utf8')));
+}
+
+assert.throws(function() {
+  fs.readFileSync(path.join(common.tmpDir, 'does-not-exist'));
+}, function(e) {
+  return e.code === 'ENOENT' && /does-not-exist/.test(e.path);
+});
+
+assert.throws(function() {
+  fs.readFileSync(common.tmpDir);
+}, function(e) {
+  return e.code === 'EISDIR';
+});
+
+var callbacks = 0;
+
+fs.readFile(path.join(common.tmpDir, 'does-not-exist'), function(er, data) {
+  assert.equal(er.code, 'ENOENT');
+  assert.equal(data, undefined);
+  callbacks++;
+});
+
+fs.readFile(common.tmpDir, function(er) {
+  assert.equal(er.code, 'EISDIR');
+  callbacks++;
+});
+
+fs.writeFile(filename, big, { fsync: true }, function(er) {
+  assert.ifError(er);
+  fs.readFile(filename, function(er, data) {
+    assert.ifError(er);
+    assert.deepEqual(data, big);
+    fs.writeFile(filename, 'ghi', { flag: 'a' }, function(er) {
+      assert.ifError(er);
+      fs.readFile(filename, 'binary', function(er, data) {
+        assert.ifError(er);
+        assert.equal(data.length, big.length + 3);
+        assert.equal(data.slice(-3), 'ghi');
+        callbacks++;
+      });
+    });
+  });
+});
+
+process.on('exit', function() {
+  assert.equal(callbacks, 3);
+});
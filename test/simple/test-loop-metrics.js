@@ -0,0 +1,100 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var fs = require('fs');
+var uv = process.binding('uv');
+
+var metrics = uv.loopMetrics;
+
+function snapshot() {
+  var fields = [];
+  for (var i = 0; i < uv.kLoopTimerLateness + uv.kLoopTimerLatenessBuckets; i++)
+    fields.push(metrics[i]);
+  return fields;
+}
+
+function lateness(fields) {
+  var sum = 0;
+  for (var i = 0; i < uv.kLoopTimerLatenessBuckets; i++)
+    sum += fields[uv.kLoopTimerLateness + i];
+  return sum;
+}
+
+// Nothing is recorded until the metrics are started.
+assert.equal(lateness(snapshot()), 0);
+assert.equal(metrics[uv.kLoopIterations], 0);
+
+uv.startLoopMetrics();
+uv.startLoopMetrics();  // Starting twice is harmless.
+
+var timers = 0;
+var reads = 0;
+
+for (var i = 0; i < 5; i++) {
+  setTimeout(function() {
+    timers++;
+    fs.readFile(__filename, function(err) {
+      assert.ifError(err);
+      reads++;
+    });
+  }, 10 * i);
+}
+
+// A timer callback that blocks for a while delays a timer that is due in the
+// meantime.  The lateness is measured against the clock, not the loop time
+// that is only updated once per loop iteration.
+setTimeout(function() {
+  setTimeout(function() {
+    timers++;
+  }, 1);
+  var start = process.hrtime();
+  for (;;) {
+    var elapsed = process.hrtime(start);
+    if (elapsed[0] * 1e3 + elapsed[1] / 1e6 >= 50)
+      break;
+  }
+}, 60);
+
+setTimeout(function() {
+  assert.equal(timers, 6);
+  assert.equal(reads, 5);
+
+  var fields = snapshot();
+  assert.ok(fields[uv.kLoopIterations] > 0);
+  assert.ok(fields[uv.kLoopEvents] >= 12);
+  assert.ok(fields[uv.kLoopIdleTime] > 0);
+  assert.ok(fields[uv.kLoopBusyTime] >= 50);
+  assert.ok(lateness(fields) >= 7);
+  // The delayed timer was at least 32 ms late.
+  var late = 0;
+  for (var i = 6; i < uv.kLoopTimerLatenessBuckets; i++)
+    late += fields[uv.kLoopTimerLateness + i];
+  assert.ok(late >= 1);
+
+  uv.stopLoopMetrics();
+  uv.stopLoopMetrics();  // Stopping twice is harmless.
+
+  setTimeout(function() {
+    assert.deepEqual(snapshot(), fields);
+  }, 10);
+}, 200);
@@ -0,0 +1,121 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+var common = require('../common');
+var assert = require('assert');
+var fs = require('fs');
+var path = require('path');
+var spawn = require('child_process').spawn;
+
+var cacheRoot = path.join(common.tmpDir, 'code-cache');
+// Its parents are created too.
+var cacheDir = path.join(cacheRoot, 'a', 'b');
+var moduleFile = path.join(common.tmpDir, 'code-cache-module.js');
+
+// Big enough for V8 to produce cached data.
+fs.writeFileSync(moduleFile,
+                 'function f() { return "' + new Array(2048).join('x') +
+                 '"; }\nconsole.log(f().length);\n');
+
+function rmrf(p) {
+  try {
+    if (fs.lstatSync(p).isDirectory()) {
+      fs.readdirSync(p).forEach(function(name) {
+        rmrf(path.join(p, name));
+      });
+      fs.rmdirSync(p);
+    } else {
+      fs.unlinkSync(p);
+    }
+  } catch (e) {
+  }
+}
+
+function cleanup() {
+  rmrf(cacheRoot);
+}
+
+function run(cb) {
+  var env = {};
+  for (var k in process.env) env[k] = process.env[k];
+  env.NODE_CODE_CACHE_DIR = cacheDir;
+  var child = spawn(process.execPath, [moduleFile], { env: env });
+  var stdout = '';
+  child.stdout.setEncoding('utf8');
+  child.stdout.on('data', function(s) { stdout += s; });
+  child.on('exit', function(code) {
+    assert.equal(code, 0);
+    assert.equal(stdout, '2047\n');
+    cb();
+  });
+}
+
+function cacheFiles() {
+  return fs.readdirSync(cacheDir).filter(function(name) {
+    return /\.cache$/.test(name);
+  });
+}
+
+cleanup();
+
+function cacheKey(file) {
+  var buf = fs.readFileSync(file);
+  return buf.toString('utf8', 4, 4 + buf.readUInt32LE(0)).split('\0');
+}
+
+// First run creates the cache directory and populates it.
+run(function() {
+  var files = cacheFiles();
+  assert.equal(files.length, 1);
+  var file = path.join(cacheDir, files[0]);
+  var mtime = fs.statSync(file).mtime.getTime();
+
+  // Second run uses the cache without rewriting it.
+  run(function() {
+    assert.equal(fs.statSync(file).mtime.getTime(), mtime);
+
+    // Corrupt cache data is dropped and the module still loads.
+    var buf = fs.readFileSync(file);
+    var keyLength = buf.readUInt32LE(0);
+    buf.fill(0xff, 4 + keyLength);
+    fs.writeFileSync(file, buf);
+    run(function() {
+      assert(!fs.existsSync(file));
+
+      // A changed module overwrites its entry instead of adding one.
+      run(function() {
+        assert.deepEqual(cacheFiles(), files);
+        var oldKey = cacheKey(file);
+        var time = new Date(Date.now() - 3600 * 1000);
+        fs.utimesSync(moduleFile, time, time);
+        run(function() {
+          assert.deepEqual(cacheFiles(), files);
+          var newKey = cacheKey(file);
+          assert.notEqual(newKey[1], oldKey[1]);
+          var mtime = fs.statSync(moduleFile).mtime.getTime();
+          assert.equal(newKey[1], String(mtime));
+          cleanup();
+        });
+      });
+    });
+  });
+});
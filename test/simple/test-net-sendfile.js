@@ -0,0 +1,145 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var crypto = require('crypto');
+var path = require('path');
+var net = require('net');
+var fs = require('fs');
+
+// Big enough to fill the socket buffers a couple of times over.
+var filename = path.join(common.tmpDir, 'sendfile.bin');
+var data = crypto.pseudoRandomBytes(8 * 1024 * 1024 + 123);
+fs.writeFileSync(filename, data);
+var fd = fs.openSync(filename, 'r');
+
+var offset = 1000;
+var length = data.length - 2000;
+var expected = Buffer.concat([
+  new Buffer('head'),
+  data.slice(offset, offset + length),
+  new Buffer('tail')
+]);
+
+var callbacks = 0;
+
+var server = net.createServer(function(conn) {
+  // Writes before and after the file go out in order.
+  conn.write('head');
+  conn.sendFile(fd, offset, length, function(err) {
+    assert.ifError(err);
+    callbacks++;
+  });
+  conn.end('tail');
+});
+
+server.listen(common.PORT, function() {
+  var chunks = [];
+  var client = net.connect(common.PORT);
+  // Read slowly at first so the server has to wait for writability.
+  client.pause();
+  setTimeout(function() {
+    client.resume();
+  }, 200);
+  client.on('data', function(chunk) {
+    chunks.push(chunk);
+  });
+  client.on('end', function() {
+    var received = Buffer.concat(chunks);
+    assert.equal(received.length, expected.length);
+    assert(received.toString('hex') === expected.toString('hex'));
+    callbacks++;
+    shortFile();
+  });
+});
+
+// A file that's shorter than promised is a write error.
+function shortFile() {
+  server.close();
+  server = net.createServer(function(conn) {
+    conn.on('error', function(err) {
+      assert.equal(err.code, 'EOF');
+      callbacks++;
+      conn.destroy();
+    });
+    conn.sendFile(fd, data.length - 10, 100);
+  });
+  server.listen(common.PORT, function() {
+    net.connect(common.PORT).on('close', function() {
+      server.close();
+      overPipe();
+    }).resume();
+  });
+}
+
+// Pipes don't support sendfile(2) and fall back to reading the file.
+function overPipe() {
+  server = net.createServer(function(conn) {
+    conn.sendFile(fd, offset, length, function(err) {
+      assert.ifError(err);
+      callbacks++;
+    });
+    conn.end();
+  });
+  server.listen(common.PIPE, function() {
+    var chunks = [];
+    net.connect(common.PIPE).on('data', function(chunk) {
+      chunks.push(chunk);
+    }).on('end', function() {
+      var received = Buffer.concat(chunks);
+      assert.equal(received.length, length);
+      assert(received.toString('hex') ===
+             data.slice(offset, offset + length).toString('hex'));
+      server.close();
+      destroyMidway();
+    });
+  });
+}
+
+// Destroying the socket while the transfer is stalled doesn't crash and
+// doesn't call the callback.
+function destroyMidway() {
+  var client;
+  server = net.createServer(function(conn) {
+    conn.sendFile(fd, 0, data.length, assert.fail);
+    setTimeout(function() {
+      conn.destroy();
+      client.destroy();
+      server.close();
+      callbacks++;
+    }, 100);
+  });
+  server.listen(common.PORT, function() {
+    // Never reads, so the transfer stalls once the buffers are full.
+    client = net.connect(common.PORT);
+    client.pause();
+  });
+}
+
+assert.throws(function() {
+  new net.Socket().sendFile('foo', 0, 1);
+}, TypeError);
+
+process.on('exit', function() {
+  fs.closeSync(fd);
+  assert.equal(callbacks, 5);
+});
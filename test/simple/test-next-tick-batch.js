@@ -0,0 +1,66 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var fs = require('fs');
+var spawn = require('child_process').spawn;
+
+if (process.argv[2] === 'child') {
+  var order = [];
+  var pending = 8;
+
+  // Ticks queued by I/O callbacks still run before immediates and timers.
+  for (var i = 0; i < pending; i++) {
+    fs.stat(__filename, function(err) {
+      assert.ifError(err);
+      order.push('stat');
+      process.nextTick(function() {
+        order.push('tick');
+        if (--pending === 0) {
+          setImmediate(function() { order.push('immediate'); });
+          setTimeout(function() { order.push('timeout'); }, 1);
+        }
+      });
+    });
+  }
+
+  process.on('exit', function() {
+    var stats = order.filter(function(s) { return s === 'stat'; });
+    var ticks = order.filter(function(s) { return s === 'tick'; });
+    assert.equal(stats.length, 8);
+    assert.equal(ticks.length, 8);
+    assert.deepEqual(order.slice(-2), ['immediate', 'timeout']);
+    console.log('ok');
+  });
+  return;
+}
+
+var child = spawn(process.execPath,
+                  ['--batch-ticks', __filename, 'child']);
+var stdout = '';
+child.stdout.setEncoding('utf8');
+child.stdout.on('data', function(s) { stdout += s; });
+child.stderr.pipe(process.stderr);
+child.on('exit', function(code) {
+  assert.equal(code, 0);
+  assert.equal(stdout, 'ok\n');
+});
@@ -0,0 +1,83 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+if (process.platform !== 'linux' ||
+    !process.config.variables.node_use_perfctr) {
+  console.error('Skipping because node compiled without --with-perfctr.');
+  process.exit(0);
+}
+
+var common = require('../common');
+var assert = require('assert');
+var fs = require('fs');
+var http = require('http');
+
+var path = '/dev/shm/node-' + process.pid;
+
+// See src/node_linux_perfctr_provider.h for the layout.
+function counters() {
+  var data = fs.readFileSync(path);
+  assert.equal(data.readUInt32LE(0), 0x6e6f6463);
+  assert.equal(data.readUInt32LE(4), 1);
+  assert.equal(data.readUInt32LE(8), process.pid);
+  var count = data.readUInt32LE(12);
+  assert.ok(count >= 10);
+  var values = [];
+  for (var i = 0; i < count; i++)
+    values.push(data.readUInt32LE(16 + 8 * i));  // Low half is enough here.
+  return values;
+}
+
+var HTTP_SERVER_REQUEST = 0;
+var HTTP_SERVER_RESPONSE = 1;
+var HTTP_CLIENT_REQUEST = 2;
+var HTTP_CLIENT_RESPONSE = 3;
+var SERVER_CONNS = 4;
+var NET_BYTES_SENT = 5;
+var NET_BYTES_RECV = 6;
+
+var before = counters();
+
+var server = http.createServer(function(req, res) {
+  res.end('hello');
+});
+
+server.listen(common.PORT, function() {
+  http.get({ port: common.PORT, agent: false }, function(res) {
+    res.resume();
+    res.on('end', function() {
+      var after = counters();
+      assert.equal(after[HTTP_SERVER_REQUEST] - before[HTTP_SERVER_REQUEST], 1);
+      assert.equal(after[HTTP_SERVER_RESPONSE] - before[HTTP_SERVER_RESPONSE],
+                   1);
+      assert.equal(after[HTTP_CLIENT_REQUEST] - before[HTTP_CLIENT_REQUEST], 1);
+      assert.equal(after[HTTP_CLIENT_RESPONSE] - before[HTTP_CLIENT_RESPONSE],
+                   1);
+      assert.ok(after[NET_BYTES_SENT] > before[NET_BYTES_SENT]);
+      assert.ok(after[NET_BYTES_RECV] > before[NET_BYTES_RECV]);
+      server.close();
+    });
+  });
+});
+
+process.on('exit', function() {
+  assert.equal(counters()[SERVER_CONNS], 0);
+});
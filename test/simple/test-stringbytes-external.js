@@ -132,3 +132,25 @@ var PRE_3OF4_APEX = Math.ceil((EXTERN_APEX / 4) * 3) - RADIOS;
     }
   }
 })();
+
+// pure ASCII utf8 input takes the one-byte string fast path, make sure that
+// the result is correct on both sides of the external string threshold
+(function () {
+  var ascii = new Buffer(EXTERN_APEX + 64);
+  for (var i = 0; i < ascii.length; ++i) {
+    ascii[i] = 32 + i % 95;
+  }
+
+  [EXTERN_APEX - 1, EXTERN_APEX, EXTERN_APEX + 63].forEach(function(len) {
+    var str = ascii.slice(0, len).toString('utf8');
+    assert.equal(str.length, len);
+    assert.equal(str, ascii.slice(0, len).toString('ascii'));
+    assert.deepEqual(new Buffer(str, 'utf8'), ascii.slice(0, len));
+  });
+
+  // a single non-ASCII byte at the end must still go through the decoder
+  var utf8 = Buffer.concat([ascii, new Buffer('\u00e9', 'utf8')]);
+  var str = utf8.toString('utf8');
+  assert.equal(str.length, ascii.length + 1);
+  assert.equal(str.charAt(str.length - 1), '\u00e9');
+})();
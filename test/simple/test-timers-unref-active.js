@@ -0,0 +1,56 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+var common = require('../common');
+var assert = require('assert');
+var timers = require('timers');
+
+var fired = [];
+
+function item(name, msecs) {
+  var o = { _onTimeout: function() { fired.push(name); } };
+  timers.enroll(o, msecs);
+  timers._unrefActive(o);
+  return o;
+}
+
+// Items with different timeouts fire in order of expiry.
+item('c', 150);
+item('a', 50);
+item('b', 100);
+
+// Refreshing an item pushes it back.
+var refreshed = item('refreshed', 75);
+setTimeout(function() {
+  timers._unrefActive(refreshed);
+}, 50);
+
+// Unenrolled items never fire.
+var cancelled = item('cancelled', 50);
+timers.unenroll(cancelled);
+
+// Unref'd items don't keep the loop alive, so hold it open until all
+// of them have had a chance to fire.
+setTimeout(function() {}, 300);
+
+process.on('exit', function() {
+  assert.deepEqual(fired, ['a', 'b', 'refreshed', 'c']);
+});
@@ -0,0 +1,67 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Flags: --expose_gc
+
+var common = require('../common');
+var assert = require('assert');
+var v8 = require('tracing').v8;
+
+assert(typeof gc === 'function', 'Run this test with --expose_gc.');
+
+function sum(list) {
+  return list.reduce(function(a, b) { return a + b; }, 0);
+}
+
+gc();
+var stats = v8.getGCStatistics();
+assert.equal(stats.mark_sweep_compact.count, 0);
+assert.equal(stats.scavenge.count, 0);
+
+v8.startGCStatistics();
+var garbage = [];
+for (var i = 0; i < 1e5; i++)
+  garbage.push({ i: i });
+garbage = null;
+gc();
+gc();
+
+stats = v8.getGCStatistics();
+var msc = stats.mark_sweep_compact;
+assert.ok(msc.count >= 2);
+assert.equal(sum(msc.pause_histogram), msc.count);
+assert.ok(msc.pause_total > 0);
+assert.ok(msc.pause_max > 0);
+assert.ok(msc.pause_max <= msc.pause_total);
+assert.ok(msc.reclaimed > 0);
+assert.equal(sum(stats.scavenge.pause_histogram), stats.scavenge.count);
+
+// The 'gc' event and the statistics share the GC callbacks, removing the
+// last listener must not stop the statistics.
+function ongc() {}
+v8.on('gc', ongc);
+v8.removeListener('gc', ongc);
+gc();
+assert.equal(v8.getGCStatistics().mark_sweep_compact.count, msc.count + 1);
+
+v8.stopGCStatistics();
+gc();
+assert.equal(v8.getGCStatistics().mark_sweep_compact.count, msc.count + 1);
@@ -0,0 +1,62 @@
+// Copyright Joyent, Inc. and other Node contributors.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the
+// "Software"), to deal in the Software without restriction, including
+// without limitation the rights to use, copy, modify, merge, publish,
+// distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the
+// following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN
+// NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+// DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE
+// USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+var common = require('../common');
+var assert = require('assert');
+var vm = require('vm');
+
+// V8 only produces cached data for scripts over --min_preparse_length.
+function makeSource(tag) {
+  return '(function() {\n' +
+         '  function f() { return "' + new Array(2048).join('x') + '"; }\n' +
+         '  return f().length + ' + JSON.stringify(tag) + ';\n' +
+         '})();';
+}
+
+// Produce cached data.
+var source = makeSource('a');
+var script = new vm.Script(source, { produceCachedData: true });
+assert(Buffer.isBuffer(script.cachedData));
+assert(script.cachedData.length > 0);
+assert.equal(script.cachedDataRejected, undefined);
+assert.equal(script.runInThisContext(), '2047a');
+
+// Consume it.
+var script2 = new vm.Script(source, { cachedData: script.cachedData });
+assert.strictEqual(script2.cachedDataRejected, false);
+assert.equal(script2.cachedData, undefined);
+assert.equal(script2.runInThisContext(), '2047a');
+
+// Corrupt data is rejected but the script still compiles.
+var script3 = new vm.Script(makeSource('b'), { cachedData: new Buffer(16) });
+assert.strictEqual(script3.cachedDataRejected, true);
+assert.equal(script3.runInThisContext(), '2047b');
+
+// Syntax errors are still reported as such.
+assert.throws(function() {
+  new vm.Script('function (', { cachedData: script.cachedData });
+}, SyntaxError);
+
+// cachedData must be a Buffer.
+assert.throws(function() {
+  new vm.Script('1', { cachedData: 'nope' });
+}, /options.cachedData must be a Buffer/);
@@ -52,3 +52,22 @@ assert.throws(function() {
   vm.runInNewContext('runInVM(10)', context, { timeout: 100 });
   throw new Error('Test 5 failed');
 }, /Script execution timed out./);
+
+// Test 6: Many short-lived watchdogs, outer timeout still fires afterwards
+assert.throws(function() {
+  var context = {
+    runInVM: function(timeout) {
+      vm.runInNewContext('1', context, { timeout: timeout });
+    }
+  };
+  vm.runInNewContext('for (var i = 0; i < 1000; i++) runInVM(1000 + i % 7);' +
+                     'while(true) {}', context, { timeout: 100 });
+  throw new Error('Test 6 failed');
+}, /Script execution timed out./);
+
+// Test 7: Script finishing early doesn't cancel a later watchdog
+for (var i = 0; i < 100; i++)
+  vm.runInThisContext('', { timeout: 10 + i });
+assert.throws(function() {
+  vm.runInThisContext('while(true) {}', { timeout: 50 });
+});
@@ -0,0 +1,109 @@
+#!/usr/bin/env python
+#
+# Prints the performance counters that node processes built with
+# ./configure --with-perfctr publish in /dev/shm/node-<pid>.  Reading the
+# counters does not involve the node process.  See
+# src/node_linux_perfctr_provider.h for the segment layout.
+#
+# Usage: tools/perfctr.py [-i <seconds>] [pid ...]
+
+import errno
+import getopt
+import glob
+import os
+import struct
+import sys
+import time
+
+MAGIC = 0x6e6f6463
+VERSION = 1
+HEADER = struct.Struct('=IIII')
+
+COUNTERS = [
+  'http_server_requests',
+  'http_server_responses',
+  'http_client_requests',
+  'http_client_responses',
+  'server_connections',
+  'net_bytes_sent',
+  'net_bytes_recv',
+  'gc_percent_time',
+  'pipe_bytes_sent',
+  'pipe_bytes_recv',
+]
+
+
+def alive(pid):
+  try:
+    os.kill(pid, 0)
+  except OSError, e:
+    return e.errno == errno.EPERM
+  return True
+
+
+def read_segment(path):
+  f = open(path, 'rb')
+  try:
+    data = f.read()
+  finally:
+    f.close()
+  if len(data) < HEADER.size:
+    return None
+  magic, version, pid, count = HEADER.unpack_from(data)
+  if magic != MAGIC or version != VERSION:
+    return None
+  count = min(count, (len(data) - HEADER.size) / 8)
+  # Server connections go down as well as up, the rest only go up.
+  values = struct.unpack_from('=%dQ' % count, data, HEADER.size)
+  values = [v - (1 << 64) if v >= (1 << 63) else v for v in values]
+  return pid, values
+
+
+def segments(pids):
+  if pids:
+    paths = ['/dev/shm/node-%d' % pid for pid in pids]
+  else:
+    paths = sorted(glob.glob('/dev/shm/node-*'))
+  for path in paths:
+    try:
+      segment = read_segment(path)
+    except IOError, e:
+      print >> sys.stderr, '%s: %s' % (path, e.strerror)
+      continue
+    if segment is None:
+      print >> sys.stderr, '%s: not a node counter segment' % path
+      continue
+    pid, values = segment
+    # The segment outlives processes that are killed by a signal.
+    if not alive(pid):
+      continue
+    yield pid, values
+
+
+def main(argv):
+  try:
+    opts, args = getopt.getopt(argv, 'i:')
+  except getopt.GetoptError, e:
+    print >> sys.stderr, e
+    return 1
+  interval = 0
+  for opt, val in opts:
+    if opt == '-i':
+      interval = float(val)
+  pids = [int(arg) for arg in args]
+
+  while True:
+    for pid, values in segments(pids):
+      print 'pid %d' % pid
+      for i in range(len(values)):
+        name = i < len(COUNTERS) and COUNTERS[i] or 'counter_%d' % i
+        print '  %-24s %d' % (name, values[i])
+    if interval <= 0:
+      return 0
+    sys.stdout.flush()
+    time.sleep(interval)
+    print
+
+
+if __name__ == '__main__':
+  sys.exit(main(sys.argv[1:]))